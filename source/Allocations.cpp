@@ -0,0 +1,56 @@
+#include "pch.hpp"
+
+#include "Allocations.hpp"
+
+
+#ifdef CGE_COUNT_ALLOCATIONS
+
+namespace {
+    // Per thread, so the loader and watcher threads allocating in the background are not charged to the frame
+    thread_local size_t allocations = 0;
+}
+
+void* operator new(const size_t size) {
+    ++allocations;
+    if (void* pointer = std::malloc(size > 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size) {
+    return operator new(size);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment) {
+    ++allocations;
+    if (void* pointer = _aligned_malloc(size > 0 ? size : 1, static_cast<size_t>(alignment))) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { _aligned_free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { _aligned_free(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { _aligned_free(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { _aligned_free(pointer); }
+
+size_t heap_allocations() {
+    return allocations;
+}
+
+#else
+
+size_t heap_allocations() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Heap allocations made through operator new by the calling thread so far. Only counted in builds defining
+// CGE_COUNT_ALLOCATIONS, which replaces the global operator new; otherwise always zero.
+[[nodiscard]] size_t heap_allocations();
@@ -0,0 +1,61 @@
+#include "pch.hpp"
+
+#include "Animation.hpp"
+
+
+Animation::Animation() : frames_(1), frame_duration_(1.0), looping_(false) {}
+
+Animation::Animation(const std::vector<SpriteView>& frames, const double frame_duration, const bool looping) : frames_(frames), frame_duration_(frame_duration), looping_(looping) {
+    if (frames_.empty()) {
+        throw std::invalid_argument("Animation requires at least one frame");
+    }
+    if (frame_duration_ <= 0.0) {
+        throw std::invalid_argument("Animation frame duration must be positive");
+    }
+}
+
+
+void Animation::update(const double frame_time) {
+    time_ += frame_time;
+    if (looping_) {
+        time_ = std::fmod(time_, duration());
+    }
+}
+
+void Animation::restart() {
+    time_ = 0.0;
+}
+
+
+bool Animation::finished() const {
+    return not looping_ and time_ >= duration();
+}
+
+double Animation::duration() const {
+    return frame_duration_ * static_cast<double>(frames_.size());
+}
+
+size_t Animation::frame_index() const {
+    return index(time_);
+}
+
+const SpriteView& Animation::frame() const {
+    return frames_[index(time_)];
+}
+
+const SpriteView& Animation::frame(const double time) const {
+    return frames_[index(time)];
+}
+
+
+size_t Animation::index(const double time) const {
+    if (time <= 0.0) {
+        return 0;
+    }
+    const auto index = static_cast<size_t>(time / frame_duration_);
+    if (looping_) {
+        return index % frames_.size();
+    } else {
+        return index < frames_.size() ? index : frames_.size() - 1;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "SpriteView.hpp"
+
+
+class Animation {
+public:
+
+    Animation();
+    Animation(const std::vector<SpriteView>& frames, double frame_duration, bool looping = true);
+
+    void update(double frame_time);
+    void restart();
+
+    [[nodiscard]] bool finished() const;
+    [[nodiscard]] double duration() const;
+    [[nodiscard]] size_t frame_index() const;
+    [[nodiscard]] const SpriteView& frame() const;
+    // Frame shown at the given time since the start, independent of the animation's own clock
+    [[nodiscard]] const SpriteView& frame(double time) const;
+
+private:
+
+    std::vector<SpriteView> frames_;
+    double frame_duration_;
+    bool looping_;
+    double time_ = 0.0;
+
+    size_t index(double time) const;
+};
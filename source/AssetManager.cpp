@@ -0,0 +1,217 @@
+#include "pch.hpp"
+
+#include "AssetManager.hpp"
+
+
+AssetManager::Asset::Asset(const std::string& filename, const std::filesystem::path& path) : filename_(filename), path_(path), loaded_(promise_.get_future().share()) {}
+
+const std::string& AssetManager::Asset::filename() const {
+    return filename_;
+}
+
+bool AssetManager::Asset::ready() const {
+    return loaded_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+size_t AssetManager::Asset::size() const {
+    return ready() ? size_ : 0;
+}
+
+const Sprite& AssetManager::Asset::sprite() const {
+    loaded_.get();
+    return *sprite_;
+}
+
+
+
+AssetManager::AssetManager(const size_t memory_budget, unsigned thread_count) : memory_budget_(memory_budget) {
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency() > 2 ? std::thread::hardware_concurrency() / 2 : 1;
+    }
+    for (unsigned i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&AssetManager::work, this);
+    }
+}
+
+AssetManager::~AssetManager() {
+    watcher_.reset();
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+
+AssetManager::Handle AssetManager::load(const std::string& filename) {
+    const std::filesystem::path path = std::filesystem::absolute(filename).lexically_normal();
+    std::lock_guard lock(mutex_);
+    if (const auto found = entries_.find(path); found != entries_.end()) {
+        recently_used_.splice(recently_used_.begin(), recently_used_, found->second);
+        return *found->second;
+    }
+    if (watcher_) {
+        watcher_->watch(path.parent_path());
+    }
+    const Entry entry(new Asset(filename, path));
+    recently_used_.push_front(entry);
+    entries_.emplace(path, recently_used_.begin());
+    queue_.push_back({ entry, false });
+    work_available_.notify_one();
+    return entry;
+}
+
+
+size_t AssetManager::memory_budget() const {
+    std::lock_guard lock(mutex_);
+    return memory_budget_;
+}
+
+size_t AssetManager::memory_usage() const {
+    std::lock_guard lock(mutex_);
+    return memory_usage_;
+}
+
+void AssetManager::set_memory_budget(const size_t bytes) {
+    std::lock_guard lock(mutex_);
+    memory_budget_ = bytes;
+    evict();
+}
+
+void AssetManager::collect() {
+    std::lock_guard lock(mutex_);
+    evict();
+}
+
+
+void AssetManager::set_hot_reload(const bool enabled) {
+    // Destroyed after unlocking, also when watching throws, as its thread may be waiting on the mutex in changed()
+    std::unique_ptr<FileWatcher> watcher;
+    std::lock_guard lock(mutex_);
+    if (not enabled) {
+        watcher = std::move(watcher_);
+    } else if (not watcher_) {
+        watcher = std::make_unique<FileWatcher>([this](const std::filesystem::path& path) { changed(path); });
+        for (const Entry& entry : recently_used_) {
+            watcher->watch(entry->path_.parent_path());
+        }
+        watcher_ = std::move(watcher);
+    }
+}
+
+bool AssetManager::hot_reload() const {
+    std::lock_guard lock(mutex_);
+    return watcher_ != nullptr;
+}
+
+void AssetManager::swap_reloaded() {
+    std::unique_lock lock(mutex_, std::try_to_lock);
+    if (not lock.owns_lock() or reloaded_.empty()) {
+        return;
+    }
+    for (auto& [entry, sprite] : reloaded_) {
+        const size_t size = static_cast<size_t>(sprite->width()) * sprite->height() * sizeof(CHAR_INFO);
+        if (const auto found = entries_.find(entry->path_); found != entries_.end() and *found->second == entry) {
+            memory_usage_ = memory_usage_ - entry->size_ + size;
+        }
+        entry->size_ = size;
+        entry->sprite_ = std::move(sprite);
+        if (entry->dirty_) {
+            entry->dirty_ = false;
+            queue_.push_back({ entry, true });
+            work_available_.notify_one();
+        } else {
+            entry->reloading_ = false;
+        }
+    }
+    reloaded_.clear();
+    evict();
+}
+
+
+void AssetManager::changed(const std::filesystem::path& path) {
+    std::lock_guard lock(mutex_);
+    const auto found = entries_.find(path.lexically_normal());
+    if (found == entries_.end()) {
+        return;
+    }
+    if (const Entry& entry = *found->second; not entry->ready()) {
+        return;
+    } else if (entry->reloading_) {
+        entry->dirty_ = true;
+    } else {
+        entry->reloading_ = true;
+        queue_.push_back({ entry, true });
+        work_available_.notify_one();
+    }
+}
+
+void AssetManager::work() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex_);
+            work_available_.wait(lock, [this] { return stopping_ or not queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        const Entry& entry = job.entry;
+        if (job.reload) {
+            std::shared_ptr<const Sprite> sprite;
+            try {
+                sprite = std::make_shared<const Sprite>(entry->path_.string());
+            } catch (...) {
+                // Most likely caught mid-write; writes after this load started have marked the asset dirty
+            }
+            std::lock_guard lock(mutex_);
+            if (entry->dirty_) {
+                // What was read may already be stale
+                entry->dirty_ = false;
+                queue_.push_back({ entry, true });
+                work_available_.notify_one();
+            } else if (sprite) {
+                reloaded_.emplace_back(entry, std::move(sprite));
+            } else {
+                entry->reloading_ = false;
+            }
+            continue;
+        }
+        try {
+            auto sprite = std::make_shared<const Sprite>(entry->path_.string());
+            entry->size_ = static_cast<size_t>(sprite->width()) * sprite->height() * sizeof(CHAR_INFO);
+            entry->sprite_ = std::move(sprite);
+            {
+                std::lock_guard lock(mutex_);
+                memory_usage_ += entry->size_;
+            }
+            entry->promise_.set_value();
+        } catch (...) {
+            entry->promise_.set_exception(std::current_exception());
+            std::lock_guard lock(mutex_);
+            if (const auto found = entries_.find(entry->path_); found != entries_.end() and *found->second == entry) {
+                recently_used_.erase(found->second);
+                entries_.erase(found);
+            }
+            continue;
+        }
+        std::lock_guard lock(mutex_);
+        evict();
+    }
+}
+
+void AssetManager::evict() {
+    for (auto entry = recently_used_.end(); memory_usage_ > memory_budget_ and entry != recently_used_.begin();) {
+        --entry;
+        if (entry->use_count() == 1 and (*entry)->ready()) {
+            memory_usage_ -= (*entry)->size_;
+            entries_.erase((*entry)->path_);
+            entry = recently_used_.erase(entry);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Sprite.hpp"
+#include "FileWatcher.hpp"
+
+
+class AssetManager {
+public:
+
+    class Asset {
+    public:
+
+        [[nodiscard]] const std::string& filename() const;
+        [[nodiscard]] bool ready() const;
+        [[nodiscard]] size_t size() const;
+
+        // Blocks until loaded, rethrowing any load error. With hot reload enabled the reference is only valid until the
+        // next call to swap_reloaded()
+        [[nodiscard]] const Sprite& sprite() const;
+
+    private:
+
+        friend class AssetManager;
+
+        Asset(const std::string& filename, const std::filesystem::path& path);
+
+        const std::string filename_;
+        const std::filesystem::path path_;
+        std::shared_ptr<const Sprite> sprite_;
+        size_t size_ = 0;
+        bool reloading_ = false;
+        // Changed again while reloading, so one more reload follows the current one
+        bool dirty_ = false;
+        std::promise<void> promise_;
+        const std::shared_future<void> loaded_;
+    };
+
+    using Handle = std::shared_ptr<const Asset>;
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager(AssetManager&&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+    AssetManager& operator=(AssetManager&&) = delete;
+
+    explicit AssetManager(size_t memory_budget = 64 * 1024 * 1024, unsigned thread_count = 0);
+
+    ~AssetManager();
+
+    // Returns the shared handle for the file, queuing a background load the first time any spelling of its path is
+    // requested
+    [[nodiscard]] Handle load(const std::string& filename);
+
+    [[nodiscard]] size_t memory_budget() const;
+    [[nodiscard]] size_t memory_usage() const;
+    void set_memory_budget(size_t bytes);
+
+    // Drops loaded sprites that nothing else holds a handle to, least recently requested first, until under budget
+    void collect();
+
+    // Watches the directories of loaded files and reparses only the files that change, in the background. Enabling it,
+    // and loading while it is enabled, throw once the files span more directories than FileWatcher can watch.
+    void set_hot_reload(bool enabled);
+    [[nodiscard]] bool hot_reload() const;
+
+    // Publishes reparsed sprites to their handles. Call at a frame boundary; never waits on the loader threads
+    void swap_reloaded();
+
+private:
+
+    using Entry = std::shared_ptr<Asset>;
+
+    struct Job {
+        Entry entry;
+        bool reload;
+    };
+
+    size_t memory_budget_;
+    size_t memory_usage_ = 0;
+
+    std::list<Entry> recently_used_;
+    // Keyed by absolute, normalized path, so every spelling of a file shares one entry
+    std::map<std::filesystem::path, std::list<Entry>::iterator> entries_;
+
+    std::unique_ptr<FileWatcher> watcher_;
+    std::vector<std::pair<Entry, std::shared_ptr<const Sprite>>> reloaded_;
+
+    std::deque<Job> queue_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+
+    void work();
+    void evict();
+    void changed(const std::filesystem::path& path);
+};
@@ -0,0 +1,82 @@
+#include "pch.hpp"
+
+#include "BitmapFont.hpp"
+#include "Text.hpp"
+
+
+BitmapFont::BitmapFont(const Sprite& sheet, const Coordinate<int>& glyph_dimensions, const std::string_view characters, const int spacing)
+    : atlas_(sheet, glyph_dimensions), glyph_dimensions_(glyph_dimensions), spacing_(spacing) {
+    if (spacing < 0) {
+        throw std::invalid_argument("Font spacing cannot be negative");
+    }
+    std::wstring glyphs;
+    Text::decode(characters, glyphs);
+    if (glyphs.size() > atlas_.size()) {
+        throw std::invalid_argument("Font sheet has fewer glyphs than characters");
+    }
+    ascii_.fill(-1);
+    for (size_t index = 0; index < glyphs.size(); ++index) {
+        if (static_cast<size_t>(glyphs[index]) < ascii_.size()) {
+            ascii_[glyphs[index]] = static_cast<int>(index);
+        } else {
+            characters_[glyphs[index]] = index;
+        }
+    }
+}
+
+const Coordinate<int>& BitmapFont::glyph_dimensions() const {
+    return glyph_dimensions_;
+}
+
+int BitmapFont::spacing() const {
+    return spacing_;
+}
+
+bool BitmapFont::contains(const WCHAR character) const {
+    return frame(character) >= 0;
+}
+
+const BitmapFont::Layout& BitmapFont::layout(const std::string_view utf8) {
+    if (const auto found = layouts_.find(utf8); found != layouts_.end()) {
+        return found->second;
+    }
+    if (layouts_.size() == cache_capacity) {
+        layouts_.clear();
+    }
+    glyphs_.clear();
+    Text::decode(utf8, glyphs_);
+    return layouts_.emplace(utf8, layout(std::wstring_view(glyphs_))).first->second;
+}
+
+BitmapFont::Layout BitmapFont::layout(const std::wstring_view text) const {
+    Layout layout;
+    layout.glyphs.reserve(text.size());
+    const Coordinate<int> advance = glyph_dimensions_ + Coordinate<int>(spacing_, spacing_);
+    Coordinate<int> cursor;
+    for (const WCHAR character : text) {
+        if (character == L'\n') {
+            cursor = { 0, cursor.y + advance.y };
+        } else {
+            if (const int frame = this->frame(character); frame >= 0) {
+                layout.glyphs.push_back({ cursor, static_cast<size_t>(frame) });
+            }
+            cursor.x += advance.x;
+            layout.dimensions.x = cursor.x - spacing_ > layout.dimensions.x ? cursor.x - spacing_ : layout.dimensions.x;
+        }
+        // Also on newlines, so trailing blank lines count towards the height as they do in Text
+        layout.dimensions.y = cursor.y + glyph_dimensions_.y;
+    }
+    return layout;
+}
+
+
+// Private
+
+
+int BitmapFont::frame(const WCHAR character) const {
+    if (static_cast<size_t>(character) < ascii_.size()) {
+        return ascii_[character];
+    }
+    const auto found = characters_.find(character);
+    return found == characters_.end() ? -1 : static_cast<int>(found->second);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Sprite.hpp"
+#include "SpriteAtlas.hpp"
+#include "Surface.hpp"
+
+
+// Font of glyphs several cells in size, cut from a sprite sheet, for titles and scoreboards. Laying out a string is
+// cached, so text drawn every frame only costs drawing its glyphs.
+class BitmapFont {
+public:
+
+    struct Glyph {
+        Coordinate<int> offset;
+        size_t frame;
+    };
+
+    struct Layout {
+        std::vector<Glyph> glyphs;
+        Coordinate<int> dimensions;
+    };
+
+    // The sheet is a grid of glyph_dimensions sized glyphs, row by row, in the order of characters, given as UTF-8.
+    // Spacing is the number of cells between glyphs and between lines.
+    BitmapFont(const Sprite& sheet, const Coordinate<int>& glyph_dimensions, std::string_view characters, int spacing = 1);
+
+    [[nodiscard]] const Coordinate<int>& glyph_dimensions() const;
+    [[nodiscard]] int spacing() const;
+    [[nodiscard]] bool contains(WCHAR) const;
+
+    // Lines split at '\n'; characters the font lacks leave a gap. Layouts of UTF-8 strings are cached; the cache is
+    // emptied once it holds cache_capacity of them, which invalidates the references returned before.
+    const Layout& layout(std::string_view utf8);
+    [[nodiscard]] Layout layout(std::wstring_view) const;
+
+    template <typename Operation = Blend::Transparent>
+    void draw(Surface& surface, const Coordinate<int>& coordinate, const std::string_view utf8, const int scale = 1) {
+        draw<Operation>(surface, coordinate, layout(utf8), scale);
+    }
+
+    template <typename Operation = Blend::Transparent>
+    void draw(Surface& surface, const Coordinate<int>& coordinate, const Layout& layout, const int scale = 1) const {
+        for (const auto& [offset, frame] : layout.glyphs) {
+            surface.draw_sprite<Operation>(coordinate + offset * scale, atlas_.view(frame), scale);
+        }
+    }
+
+    static constexpr size_t cache_capacity = 256;
+
+private:
+
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(const std::string_view string) const { return std::hash<std::string_view>()(string); }
+    };
+
+    SpriteAtlas atlas_;
+    Coordinate<int> glyph_dimensions_;
+    int spacing_;
+    // Frame of every ASCII character, or -1; other characters are looked up in the map
+    std::array<int, 128> ascii_;
+    std::unordered_map<WCHAR, size_t> characters_;
+
+    std::unordered_map<std::string, Layout, Hash, std::equal_to<>> layouts_;
+    std::wstring glyphs_;
+
+    [[nodiscard]] int frame(WCHAR) const;
+};
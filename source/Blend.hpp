@@ -0,0 +1,92 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Pixel.hpp"
+
+
+// Ways of combining a source cell with the cell under it. They are template arguments of the drawing functions, so
+// every combination compiles to its own inner loop, and none of them branch per cell.
+namespace Blend {
+
+    // Replaces the cell
+    struct Opaque {
+        static void apply(CHAR_INFO& destination, const CHAR_INFO& source) {
+            destination = source;
+        }
+    };
+
+    // Replaces the cell unless the source is the empty shade
+    struct Transparent {
+        static void apply(CHAR_INFO& destination, const CHAR_INFO& source) {
+            const unsigned keep = 0u - static_cast<unsigned>(source.Char.UnicodeChar == static_cast<WCHAR>(Pixel::Shade::Empty));
+            destination.Char.UnicodeChar = static_cast<WCHAR>((destination.Char.UnicodeChar & keep) | (source.Char.UnicodeChar & ~keep));
+            destination.Attributes = static_cast<WORD>((destination.Attributes & keep) | (source.Attributes & ~keep));
+        }
+    };
+
+    // Recolours the cell, keeping its glyph
+    struct ColourOnly {
+        static void apply(CHAR_INFO& destination, const CHAR_INFO& source) {
+            destination.Attributes = source.Attributes;
+        }
+    };
+
+    // Replaces the glyph, keeping the cell's colours
+    struct GlyphOnly {
+        static void apply(CHAR_INFO& destination, const CHAR_INFO& source) {
+            destination.Char.UnicodeChar = source.Char.UnicodeChar;
+        }
+    };
+
+    // Exclusive or of the colours, keeping the glyph; drawing the same thing twice restores the cell
+    struct Xor {
+        static void apply(CHAR_INFO& destination, const CHAR_INFO& source) {
+            destination.Attributes ^= source.Attributes;
+        }
+    };
+
+    // Adds the coverage of the source shade to the cell's, saturating at Full, in the source's colours. Glyphs other
+    // than shades count as empty.
+    struct Additive {
+        static void apply(CHAR_INFO& destination, const CHAR_INFO& source) {
+            destination.Char.UnicodeChar = glyphs_[level(destination.Char.UnicodeChar) + level(source.Char.UnicodeChar)];
+            destination.Attributes = source.Attributes;
+        }
+
+    private:
+
+        // The five shade glyphs all differ in their low six bits, which index these tables
+        static constexpr std::array<WCHAR, 64> slots_ = [] {
+            std::array<WCHAR, 64> slots = {};
+            for (const Pixel::Shade shade : { Pixel::Shade::Empty, Pixel::Shade::Quarter, Pixel::Shade::Half, Pixel::Shade::ThreeQuarters, Pixel::Shade::Full }) {
+                slots[static_cast<WCHAR>(shade) & 0x3F] = static_cast<WCHAR>(shade);
+            }
+            return slots;
+        }();
+        static constexpr std::array<uint8_t, 64> levels_ = [] {
+            std::array<uint8_t, 64> levels = {};
+            levels[static_cast<WCHAR>(Pixel::Shade::Quarter) & 0x3F] = 1;
+            levels[static_cast<WCHAR>(Pixel::Shade::Half) & 0x3F] = 2;
+            levels[static_cast<WCHAR>(Pixel::Shade::ThreeQuarters) & 0x3F] = 3;
+            levels[static_cast<WCHAR>(Pixel::Shade::Full) & 0x3F] = 4;
+            return levels;
+        }();
+        static constexpr std::array<WCHAR, 9> glyphs_ = {
+            static_cast<WCHAR>(Pixel::Shade::Empty),
+            static_cast<WCHAR>(Pixel::Shade::Quarter),
+            static_cast<WCHAR>(Pixel::Shade::Half),
+            static_cast<WCHAR>(Pixel::Shade::ThreeQuarters),
+            static_cast<WCHAR>(Pixel::Shade::Full),
+            static_cast<WCHAR>(Pixel::Shade::Full),
+            static_cast<WCHAR>(Pixel::Shade::Full),
+            static_cast<WCHAR>(Pixel::Shade::Full),
+            static_cast<WCHAR>(Pixel::Shade::Full),
+        };
+
+        static unsigned level(const WCHAR glyph) {
+            const unsigned slot = glyph & 0x3F;
+            return levels_[slot] & (0u - static_cast<unsigned>(slots_[slot] == glyph));
+        }
+    };
+}
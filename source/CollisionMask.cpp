@@ -0,0 +1,72 @@
+#include "pch.hpp"
+
+#include "CollisionMask.hpp"
+
+
+CollisionMask::CollisionMask() : dimensions_({ 0, 0 }), words_per_row_(0) {}
+
+CollisionMask::CollisionMask(const SpriteView& sprite) : dimensions_(sprite.dimensions()), words_per_row_((sprite.width() + 63) / 64), words_(static_cast<size_t>(words_per_row_) * sprite.height()) {
+    for (int y = 0; y < dimensions_.y; ++y) {
+        const CHAR_INFO* row = sprite.row(y);
+        uint64_t* words = words_.data() + static_cast<size_t>(y) * words_per_row_;
+        for (int x = 0; x < dimensions_.x; ++x) {
+            words[x / 64] |= static_cast<uint64_t>(row[x].Char.UnicodeChar != static_cast<WCHAR>(Pixel::Shade::Empty)) << (x % 64);
+        }
+    }
+}
+
+
+const Coordinate<int>& CollisionMask::dimensions() const {
+    return dimensions_;
+}
+
+int CollisionMask::width() const {
+    return dimensions_.x;
+}
+
+int CollisionMask::height() const {
+    return dimensions_.y;
+}
+
+bool CollisionMask::opaque(const Coordinate<int>& coordinate) const {
+    return coordinate.in_bounds(dimensions_) and bits(coordinate.y, coordinate.x) & 1;
+}
+
+size_t CollisionMask::count() const {
+    size_t count = 0;
+    for (const uint64_t word : words_) {
+        count += std::popcount(word);
+    }
+    return count;
+}
+
+
+bool CollisionMask::overlaps(const Coordinate<int>& position, const CollisionMask& other, const Coordinate<int>& other_position) const {
+    const Coordinate<int> offset = other_position - position;
+    const int top = offset.y > 0 ? offset.y : 0;
+    const int bottom = offset.y + other.dimensions_.y < dimensions_.y ? offset.y + other.dimensions_.y : dimensions_.y;
+    const int left = offset.x > 0 ? offset.x : 0;
+    const int right = offset.x + other.dimensions_.x < dimensions_.x ? offset.x + other.dimensions_.x : dimensions_.x;
+    if (top >= bottom or left >= right) {
+        return false;
+    }
+    for (int y = top; y < bottom; ++y) {
+        const uint64_t* words = words_.data() + static_cast<size_t>(y) * words_per_row_;
+        for (int word = left / 64; word <= (right - 1) / 64; ++word) {
+            if (words[word] & other.bits(y - offset.y, word * 64 - offset.x)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+uint64_t CollisionMask::bits(const int y, const int x) const {
+    const int word = x >= 0 ? x / 64 : -((63 - x) / 64);
+    const int shift = x - word * 64;
+    const uint64_t* words = words_.data() + static_cast<size_t>(y) * words_per_row_;
+    const uint64_t low = word >= 0 and word < words_per_row_ ? words[word] : 0;
+    const uint64_t high = word + 1 >= 0 and word + 1 < words_per_row_ ? words[word + 1] : 0;
+    return shift == 0 ? low : (low >> shift) | (high << (64 - shift));
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "SpriteView.hpp"
+
+
+// One bit per cell, set where the sprite is not Shade::Empty, 64 cells to a word so overlaps test a word at a time
+class CollisionMask {
+public:
+
+    CollisionMask();
+    CollisionMask(const SpriteView&);
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] int width() const;
+    [[nodiscard]] int height() const;
+
+    [[nodiscard]] bool opaque(const Coordinate<int>& coordinate) const;
+    [[nodiscard]] size_t count() const;
+
+    [[nodiscard]] bool overlaps(const Coordinate<int>& position, const CollisionMask& other, const Coordinate<int>& other_position) const;
+
+private:
+
+    Coordinate<int> dimensions_;
+    int words_per_row_;
+    std::vector<uint64_t> words_;
+
+    // 64 bits of a row starting at any, possibly negative, column, zero outside the mask
+    uint64_t bits(int y, int x) const;
+};
@@ -5,7 +5,7 @@
 
 
 ConsoleGraphicsEngine::ConsoleGraphicsEngine(const Coordinate<int>& screen_dimensions, const Coordinate<int>& font_dimensions, const std::string& title)
-    : screen_dimensions_(screen_dimensions), title_(title), buffer_(screen_dimensions.x* screen_dimensions.y), window_region_(std::make_unique<SMALL_RECT>(0, 0, static_cast<SHORT>(screen_dimensions.x - 1), static_cast<SHORT>(screen_dimensions.y - 1))) {
+    : Surface(screen_dimensions, Pixel::Colour::Black), title_(title), window_region_(std::make_unique<SMALL_RECT>(0, 0, static_cast<SHORT>(screen_dimensions.x - 1), static_cast<SHORT>(screen_dimensions.y - 1))), post_process_(jobs_), world_(jobs_), particles_(jobs_), console_dimensions_(screen_dimensions), presented_(screen_dimensions), dirty_(screen_dimensions.y) {
     if (console_.output == INVALID_HANDLE_VALUE) {
         throw std::runtime_error("Failed to get output console handle");
     }
@@ -74,6 +74,9 @@ ConsoleGraphicsEngine::ConsoleGraphicsEngine(const Coordinate<int>& screen_dimen
         throw std::runtime_error("Failed to set input console modes");
     }
 
+    window_title_ = title + " - FPS: ";
+    window_title_.reserve(window_title_.size() + 32);
+
     if (not SetConsoleTitleA(title.c_str())) {
         throw std::runtime_error("Failed to set console title");
     }
@@ -83,10 +86,42 @@ ConsoleGraphicsEngine::ConsoleGraphicsEngine(const Coordinate<int>& screen_dimen
     }
 }
 
+ConsoleGraphicsEngine::ConsoleGraphicsEngine(const Coordinate<int>& screen_dimensions, const std::string& replay_filename, const bool real_time)
+    : Surface(screen_dimensions, Pixel::Colour::Black), title_(), window_region_(std::make_unique<SMALL_RECT>(0, 0, static_cast<SHORT>(screen_dimensions.x - 1), static_cast<SHORT>(screen_dimensions.y - 1))), post_process_(jobs_), world_(jobs_), particles_(jobs_), console_dimensions_(screen_dimensions), presented_(screen_dimensions), dirty_(screen_dimensions.y) {
+    replay_ = std::make_unique<InputReplay>(replay_filename);
+    real_time_ = real_time;
+    replay_frame_times_.reserve(replay_->size());
+}
+
 ConsoleGraphicsEngine::~ConsoleGraphicsEngine() {
     stop();
 }
 
+void ConsoleGraphicsEngine::record(const std::string& filename) {
+    recorder_ = std::make_unique<InputRecorder>(filename);
+}
+
+const std::vector<double>& ConsoleGraphicsEngine::replay_frame_times() const {
+    return replay_frame_times_;
+}
+
+void ConsoleGraphicsEngine::record_frames(const std::string& filename, const int keyframe_interval) {
+    frame_recorder_ = std::make_unique<FrameRecorder>(filename, console_dimensions_, keyframe_interval);
+}
+
+FramePlayer& ConsoleGraphicsEngine::play_frames(const std::string& filename) {
+    auto player = std::make_unique<FramePlayer>(filename);
+    if (player->dimensions() != console_dimensions_) {
+        throw std::invalid_argument("'" + filename + "' was recorded at different screen dimensions");
+    }
+    frame_player_ = std::move(player);
+    return *frame_player_;
+}
+
+void ConsoleGraphicsEngine::export_frames(const std::string& name, const int slots) {
+    frame_exporter_ = std::make_unique<FrameExporter>(name, console_dimensions_, slots);
+}
+
 void ConsoleGraphicsEngine::start() {
     active_ = true;
     auto thread = std::thread(&ConsoleGraphicsEngine::run, this);
@@ -99,16 +134,49 @@ void ConsoleGraphicsEngine::run() {
     initialise();
 
     while (active_) {
+        const size_t allocations = heap_allocations();
+
         timer_.stop();
 
-        const double frame_time = timer_.elapsed();
-        const double frame_rate = 1.0 / frame_time;
+        double frame_time = timer_.elapsed();
 
         timer_.restart();
 
+        if (not poll_input(frame_time)) {
+            break;
+        }
+
+        frame_arena_.reset();
+
+        if (scaler_.update(frame_time)) {
+            rescale();
+        }
+
+        assets_.swap_reloaded();
+
+        if (frame_player_) {
+            frame_player_->advance(frame_time);
+        }
+
+        world_.update(frame_time);
+
+        particles_.update(frame_time);
+
         update(frame_time);
 
-        render(frame_rate);
+        post_process_.apply(*this);
+
+        if (replay_) {
+            timer_.stop();
+            replay_frame_times_.push_back(timer_.elapsed());
+            if (frame_recorder_ or frame_exporter_) {
+                capture(frame_time, presented_frame());
+            }
+        } else {
+            render(frame_time);
+        }
+
+        report_allocations(heap_allocations() - allocations);
     }
 
     close();
@@ -125,11 +193,9 @@ void ConsoleGraphicsEngine::update(const double frame_time) {
 
     clear_screen();
 
-    std::random_device random_device;
-
     // Coordinate<int> coordinate;
-    // for (coordinate.x = 0; coordinate.x < screen_dimensions_.x; ++coordinate.x) {
-    //     for (coordinate.y = 0; coordinate.y < screen_dimensions_.y; ++coordinate.y) {
+    // for (coordinate.x = 0; coordinate.x < dimensions_.x; ++coordinate.x) {
+    //     for (coordinate.y = 0; coordinate.y < dimensions_.y; ++coordinate.y) {
     //         draw_pixel(coordinate, Pixel(static_cast<Pixel::Colour>(random_device() % static_cast<int>(Pixel::Colour::White) + static_cast<int>(Pixel::Colour::Black))));
     //     }
     // }
@@ -143,19 +209,62 @@ void ConsoleGraphicsEngine::close() { std::cout << "Hello world!"; }
 
 
 
-void ConsoleGraphicsEngine::render(const double frame_rate) const {
-    if (not SetConsoleTitleA((title_ + " - FPS: " + std::to_string(frame_rate)).c_str())) {
+void ConsoleGraphicsEngine::render(const double frame_time) {
+    std::array<char, 32> digits;
+    const char* digits_end = std::to_chars(digits.data(), digits.data() + digits.size(), 1.0 / frame_time, std::chars_format::fixed, 1).ptr;
+    window_title_.resize(title_.size() + 8);
+    window_title_.append(digits.data(), static_cast<size_t>(digits_end - digits.data()));
+    if (not SetConsoleTitleA(window_title_.c_str())) {
         throw std::runtime_error("Failed to set console title");
     }
 
-    if (not WriteConsoleOutputW(console_.output, buffer_.data(), { static_cast<SHORT>(screen_dimensions_.x), static_cast<SHORT>(screen_dimensions_.y) }, { 0, 0 }, window_region_.get())) {
+    for (const auto& [region, delta, fill] : scrolls_) {
+        const COORD destination = { static_cast<SHORT>(region.Left + delta.x), static_cast<SHORT>(region.Top + delta.y) };
+        if (presented_valid_ and ScrollConsoleScreenBufferW(console_.output, &region, &region, destination, &fill)) {
+            presented_.scroll({ region.Left, region.Top }, { region.Right - region.Left + 1, region.Bottom - region.Top + 1 }, delta, Pixel(fill));
+        }
+    }
+    scrolls_.clear();
+
+    constexpr int minimum_rows = 16;
+
+    const Surface& frame = presented_frame();
+    capture(frame_time, frame);
+
+    int first = 0, last = console_dimensions_.y - 1;
+    if (presented_valid_) {
+        const size_t row_size = static_cast<size_t>(console_dimensions_.x) * sizeof(CHAR_INFO);
+        jobs_.parallel_for(0, console_dimensions_.y, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                dirty_[y] = std::memcmp(frame.row(y), presented_.row(y), row_size) != 0;
+            }
+        }, minimum_rows);
+        while (first <= last and not dirty_[first]) {
+            ++first;
+        }
+        while (last >= first and not dirty_[last]) {
+            --last;
+        }
+        if (first > last) {
+            return;
+        }
+    }
+
+    SMALL_RECT region = { 0, static_cast<SHORT>(first), static_cast<SHORT>(console_dimensions_.x - 1), static_cast<SHORT>(last) };
+    if (not WriteConsoleOutputW(console_.output, frame.data(), { static_cast<SHORT>(console_dimensions_.x), static_cast<SHORT>(console_dimensions_.y) }, { 0, static_cast<SHORT>(first) }, &region)) {
         throw std::runtime_error("Failed to draw to console");
     }
+    jobs_.parallel_for(first, last + 1, [&](const int begin, const int end) {
+        std::copy(frame.row(begin), frame.row(end), presented_.row(begin));
+    }, minimum_rows);
+    presented_valid_ = true;
 }
 
 void ConsoleGraphicsEngine::stop() const {
     active_ = false;
-    SetConsoleActiveScreenBuffer(console_.original);
+    if (not replay_) {
+        SetConsoleActiveScreenBuffer(console_.original);
+    }
     game_finished_.notify_one();
 }
 
@@ -165,23 +274,63 @@ void ConsoleGraphicsEngine::stop() const {
 
 
 const Coordinate<int>& ConsoleGraphicsEngine::screen_dimensions() const {
-    return screen_dimensions_;
+    return dimensions_;
 }
 
 int ConsoleGraphicsEngine::screen_width() const {
-    return screen_dimensions_.x;
+    return dimensions_.x;
 }
 
 int ConsoleGraphicsEngine::screen_height() const {
-    return screen_dimensions_.y;
+    return dimensions_.y;
+}
+
+Surface& ConsoleGraphicsEngine::screen() {
+    return *this;
+}
+
+JobSystem& ConsoleGraphicsEngine::jobs() {
+    return jobs_;
+}
+
+FrameArena& ConsoleGraphicsEngine::frame_arena() {
+    return frame_arena_;
+}
+
+void ConsoleGraphicsEngine::set_frame_budget(const double seconds) {
+    scaler_.set_budget(seconds);
+}
+
+int ConsoleGraphicsEngine::resolution_divisor() const {
+    return scaler_.divisor();
+}
+
+size_t ConsoleGraphicsEngine::frame_allocations() const {
+    return frame_allocations_;
+}
+
+AssetManager& ConsoleGraphicsEngine::assets() {
+    return assets_;
+}
+
+PostProcess& ConsoleGraphicsEngine::post_process() {
+    return post_process_;
+}
+
+World& ConsoleGraphicsEngine::world() {
+    return world_;
+}
+
+ParticleSystem& ConsoleGraphicsEngine::particles() {
+    return particles_;
 }
 
 
-ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::key(Key key) {
+ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::key(Key key) const {
     return button(static_cast<char>(key));
 }
 
-ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::key(const char key) {
+ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::key(const char key) const {
     if ((key >= 'A' and key <= 'Z') or (key >= '0' and key <= '9')) {
         return button(key);
     } else {
@@ -190,27 +339,22 @@ ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::key(const char key) {
 }
 
 
-ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::mouse_button(const MouseButton mouse_button) {
+ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::mouse_button(const MouseButton mouse_button) const {
     return button(static_cast<const char>(mouse_button));
 }
 
 
-const Coordinate<int>& ConsoleGraphicsEngine::mouse_position() {
-    for (const auto& input_records = input_record();
-        const auto & [event_type, event] : input_records) {
-        if (event_type == MOUSE_EVENT and event.MouseEvent.dwEventFlags == MOUSE_MOVED) {
-            mouse_position_ = { event.MouseEvent.dwMousePosition.X, event.MouseEvent.dwMousePosition.Y };
-        }
-    }
-    return mouse_position_;
+// Input records console cells; the screen is smaller while the resolution is scaled down
+Coordinate<int> ConsoleGraphicsEngine::mouse_position() const {
+    return input_.mouse / scaler_.divisor();
 }
 
-int ConsoleGraphicsEngine::mouse_x() {
-    return mouse_position().x;
+int ConsoleGraphicsEngine::mouse_x() const {
+    return input_.mouse.x / scaler_.divisor();
 }
 
-int ConsoleGraphicsEngine::mouse_y() {
-    return mouse_position().y;
+int ConsoleGraphicsEngine::mouse_y() const {
+    return input_.mouse.y / scaler_.divisor();
 }
 
 
@@ -234,326 +378,156 @@ bool ConsoleGraphicsEngine::is_active() {
     return GetConsoleWindow() == GetForegroundWindow();
 }
 
-ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::button(const char button) {
-    if (not is_active()) {
+ConsoleGraphicsEngine::ButtonState ConsoleGraphicsEngine::button(const char button) const {
+    const auto index = static_cast<unsigned char>(button);
+    if (not input_.down[index]) {
         return ButtonState::Released;
-    }
-    if (const auto state = GetAsyncKeyState(button); state & 0x8000) {
-        if (state & 0x0001) {
-            return ButtonState::Pressed;
-        } else {
-            return ButtonState::Held;
-        }
+    } else if (previous_input_.down[index]) {
+        return ButtonState::Held;
     } else {
-        return ButtonState::Released;
-    }
-}
-
-std::vector<INPUT_RECORD> ConsoleGraphicsEngine::input_record() const {
-    DWORD num_events = 0;
-    if (not GetNumberOfConsoleInputEvents(console_.input, &num_events)) {
-        throw std::runtime_error("Failed to get number of console input events");
-    }
-    std::vector<INPUT_RECORD> input_records(num_events);
-    if (num_events > 0) {
-        ReadConsoleInputW(console_.input, input_records.data(), num_events, &num_events);
+        return ButtonState::Pressed;
     }
-    return input_records;
 }
 
+bool ConsoleGraphicsEngine::poll_input(double& frame_time) {
+    previous_input_ = input_;
 
-
-// Drawing functions
-
-
-void ConsoleGraphicsEngine::clear_screen(const Pixel& pixel) {
-    Coordinate<int> coordinate;
-    for (coordinate.x = 0; coordinate.x < screen_dimensions_.x; ++coordinate.x) {
-        for (coordinate.y = 0; coordinate.y < screen_dimensions_.y; ++coordinate.y) {
-            draw_pixel(coordinate, pixel);
+    if (replay_) {
+        const double measured = frame_time;
+        if (not replay_->next(frame_time, input_)) {
+            return false;
+        }
+        // Measured is the last frame's work alone, as the timer starts again after sleeping
+        if (real_time_ and frame_time > measured) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(frame_time - measured));
+            timer_.start();
         }
+        return true;
     }
-}
 
-void ConsoleGraphicsEngine::draw_character(const Coordinate<int>& coordinate, const WCHAR character, const Pixel::Colour colour) {
-    if (coordinate.in_bounds(screen_dimensions_)) {
-        const size_t index = coordinate.to_index(screen_dimensions_.x);
-        buffer_[index].Char.UnicodeChar = character;
-        buffer_[index].Attributes = static_cast<WORD>(colour);
+    const bool active = is_active();
+    for (size_t key = 1; key < input_.down.size(); ++key) {
+        input_.down[key] = active and (GetAsyncKeyState(static_cast<int>(key)) & 0x8000);
     }
-}
-
-void ConsoleGraphicsEngine::draw_pixel(const Coordinate<int>& coordinate, const Pixel& pixel) {
-    draw_character(coordinate, static_cast<WCHAR>(pixel.shade), pixel.colour);
-}
-
-void ConsoleGraphicsEngine::draw_sprite(const Coordinate<int>& coordinate, const Sprite& sprite, const int scale) {
-    const Coordinate<int>& dimensions = sprite.dimensions() * scale;
-    Coordinate<int> current;
-    for (current.x = 0; current.x < dimensions.x; ++current.x) {
-        for (current.y = 0; current.y < dimensions.y; ++current.y) {
-            if (const Pixel& pixel = sprite.pixel(current / scale); pixel.shade != Pixel::Shade::Empty) {
-                draw_pixel(coordinate + current, pixel);
-            }
+    for (const auto& [event_type, event] : input_record()) {
+        if (event_type == MOUSE_EVENT and event.MouseEvent.dwEventFlags == MOUSE_MOVED) {
+            input_.mouse = { event.MouseEvent.dwMousePosition.X, event.MouseEvent.dwMousePosition.Y };
         }
     }
-}
 
-void ConsoleGraphicsEngine::draw_string(const Coordinate<int>& coordinate, const std::wstring& string, Pixel::Colour colour) {
-    for (Coordinate<int> current = { 0, 0 }; current.x < static_cast<int>(string.length()); ++current.x) {
-        draw_character(coordinate + current, string[current.x], colour);
+    if (recorder_) {
+        recorder_->record(frame_time, input_);
     }
+    return true;
 }
 
-void ConsoleGraphicsEngine::draw_string(const Coordinate<int>& coordinate, const std::string& string, Pixel::Colour colour) {
-    for (Coordinate<int> current = { 0, 0 }; current.x < static_cast<int>(string.length()); ++current.x) {
-        draw_character(coordinate + current, static_cast<WCHAR>(string[current.x]), colour);
+std::span<const INPUT_RECORD> ConsoleGraphicsEngine::input_record() {
+    DWORD num_events = 0;
+    if (not GetNumberOfConsoleInputEvents(console_.input, &num_events)) {
+        throw std::runtime_error("Failed to get number of console input events");
     }
+    if (num_events == 0) {
+        return {};
+    }
+    const std::span<INPUT_RECORD> input_records = frame_arena_.array<INPUT_RECORD>(num_events);
+    ReadConsoleInputW(console_.input, input_records.data(), num_events, &num_events);
+    return input_records.first(num_events);
 }
 
-void ConsoleGraphicsEngine::draw_line(const Coordinate<int>& start, const Coordinate<int>& end, const Pixel& pixel) {
-    Coordinate<int> current = start;
-    Coordinate<int> delta = end - start;
-    const Coordinate<int> step = { (delta.x > 0) - (delta.x < 0), (delta.y > 0) - (delta.y < 0) };
-    auto abs = [](int x) { return x > 0 ? x : -x; };
-    delta = { abs(delta.x), abs(delta.y) };
+void ConsoleGraphicsEngine::rescale() {
+    const int divisor = scaler_.divisor();
+    resize({ (console_dimensions_.x + divisor - 1) / divisor, (console_dimensions_.y + divisor - 1) / divisor }, Pixel::Colour::Black);
+    if (divisor > 1 and upscaled_.dimensions() != console_dimensions_) {
+        upscaled_ = Surface(console_dimensions_);
+    }
+    // Queued scrolls are in the old resolution's cells
+    scrolls_.clear();
+}
 
-    if (delta.x > delta.y) {
-        int error = delta.x / 2;
-        while (current.x != end.x) {
-            draw_pixel(current, pixel);
-            error -= delta.y;
-            if (error < 0) {
-                current.y += step.y;
-                error += delta.x;
-            }
-            current.x += step.x;
-        }
-    } else {
-        int error = delta.y / 2;
-        while (current.y != end.y) {
-            draw_pixel(current, pixel);
-            error -= delta.x;
-            if (error < 0) {
-                current.x += step.x;
-                error += delta.y;
-            }
-            current.y += step.y;
-        }
+const Surface& ConsoleGraphicsEngine::presented_frame() {
+    if (frame_player_) {
+        return frame_player_->frame();
     }
+    return scaler_.divisor() == 1 ? static_cast<const Surface&>(*this) : upscale();
 }
 
-void ConsoleGraphicsEngine::draw_triangle(const std::array<Coordinate<int>, 3>& vertices, const Pixel& pixel) {
-    draw_line(vertices[0], vertices[1], pixel);
-    draw_line(vertices[1], vertices[2], pixel);
-    draw_line(vertices[2], vertices[0], pixel);
+void ConsoleGraphicsEngine::capture(const double frame_time, const Surface& frame) {
+    if (frame_recorder_) {
+        frame_recorder_->record(frame_time, frame);
+    }
+    if (frame_exporter_) {
+        frame_exporter_->publish(frame_time, frame);
+    }
 }
 
-void ConsoleGraphicsEngine::draw_filled_triangle(const std::array<Coordinate<int>, 3>& vertices, const Pixel& pixel) {
-    // auto swap = [](Coordinate<int>& a, Coordinate<int>& b) {
-    //     const Coordinate<int> temp = a;
-    // 	a = b;
-    // 	b = temp;
-    // };
-    // auto draw_scan_line = [&](const Coordinate<int>& start, const Coordinate<int>& end) {
-    //     for (int x = start.x; x <= end.x; ++x) {
-    //         draw_pixel(Coordinate<int>(x, start.y), pixel);
-    //     }
-    // };
-
-    // std::array<Coordinate<int>, 3> sorted_vertices = vertices;
-    // std::sort(sorted_vertices.begin(), sorted_vertices.end(), [](const Coordinate<int>& a, const Coordinate<int>& b) { return a.y < b.y; }
-
-    int x1 = vertices[0].x; int y1 = vertices[0].y;
-    int x2 = vertices[1].x; int y2 = vertices[1].y;
-    int x3 = vertices[2].x; int y3 = vertices[2].y;
-
-    auto SWAP = [](int& x, int& y) { int t = x; x = y; y = t; };
-    auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) draw_pixel({ i, ny }, pixel); };
-
-    int t1x, t2x, y, minx, maxx, t1xp, t2xp;
-    bool changed1 = false;
-    bool changed2 = false;
-    int signx1, signx2, dx1, dy1, dx2, dy2;
-    int e1, e2;
-    // Sort vertices
-    if (y1 > y2) { SWAP(y1, y2); SWAP(x1, x2); }
-    if (y1 > y3) { SWAP(y1, y3); SWAP(x1, x3); }
-    if (y2 > y3) { SWAP(y2, y3); SWAP(x2, x3); }
-
-    t1x = t2x = x1; y = y1;   // Starting points
-    dx1 = (int)(x2 - x1); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; } else signx1 = 1;
-    dy1 = (int)(y2 - y1);
-
-    dx2 = (int)(x3 - x1); if (dx2 < 0) { dx2 = -dx2; signx2 = -1; } else signx2 = 1;
-    dy2 = (int)(y3 - y1);
-
-    if (dy1 > dx1) {   // swap values
-        SWAP(dx1, dy1);
-        changed1 = true;
-    }
-    if (dy2 > dx2) {   // swap values
-        SWAP(dy2, dx2);
-        changed2 = true;
-    }
-
-    e2 = (int)(dx2 >> 1);
-    // Flat top, just process the second half
-    if (y1 == y2) goto next;
-    e1 = (int)(dx1 >> 1);
-
-    for (int i = 0; i < dx1;) {
-        t1xp = 0; t2xp = 0;
-        if (t1x < t2x) { minx = t1x; maxx = t2x; } else { minx = t2x; maxx = t1x; }
-        // process first line until y value is about to change
-        while (i < dx1) {
-            ++i;
-            e1 += dy1;
-            while (e1 >= dx1) {
-                e1 -= dx1;
-                if (changed1) t1xp = signx1;
-                else          goto next1;
-            }
-            if (changed1) break;
-            else t1x += signx1;
-        }
-        // Move line
-    next1:
-        // process second line until y value is about to change
-        while (true) {
-            e2 += dy2;
-            while (e2 >= dx2) {
-                e2 -= dx2;
-                if (changed2) t2xp = signx2;
-                else          goto next2;
-            }
-            if (changed2)     break;
-            else              t2x += signx2;
-        }
-    next2:
-        if (minx > t1x) minx = t1x; if (minx > t2x) minx = t2x;
-        if (maxx < t1x) maxx = t1x; if (maxx < t2x) maxx = t2x;
-        drawline(minx, maxx, y);    // Draw line from min to max points found on the y
-                                     // Now increase y
-        if (!changed1) t1x += signx1;
-        t1x += t1xp;
-        if (!changed2) t2x += signx2;
-        t2x += t2xp;
-        y += 1;
-        if (y == y2) break;
-
-    }
-next:
-    // Second half
-    dx1 = (int)(x3 - x2); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; } else signx1 = 1;
-    dy1 = (int)(y3 - y2);
-    t1x = x2;
-
-    if (dy1 > dx1) {   // swap values
-        SWAP(dy1, dx1);
-        changed1 = true;
-    } else changed1 = false;
-
-    e1 = (int)(dx1 >> 1);
-
-    for (int i = 0; i <= dx1; ++i) {
-        t1xp = 0; t2xp = 0;
-        if (t1x < t2x) { minx = t1x; maxx = t2x; } else { minx = t2x; maxx = t1x; }
-        // process first line until y value is about to change
-        while (i < dx1) {
-            e1 += dy1;
-            while (e1 >= dx1) {
-                e1 -= dx1;
-                if (changed1) { t1xp = signx1; break; } else          goto next3;
+// Nearest neighbour: every cell becomes a divisor sized block, clipped to the console
+const Surface& ConsoleGraphicsEngine::upscale() {
+    const int divisor = scaler_.divisor();
+    jobs_.parallel_for(0, dimensions_.y, [&](const int first, const int last) {
+        for (int y = first; y < last; ++y) {
+            const int top = y * divisor;
+            const int bottom = top + divisor < console_dimensions_.y ? top + divisor : console_dimensions_.y;
+            const CHAR_INFO* source = row(y);
+            CHAR_INFO* destination = upscaled_.row(top);
+            for (int x = 0; x < dimensions_.x; ++x) {
+                const int left = x * divisor;
+                std::fill_n(destination + left, left + divisor < console_dimensions_.x ? divisor : console_dimensions_.x - left, source[x]);
             }
-            if (changed1) break;
-            else   	   	  t1x += signx1;
-            if (i < dx1) ++i;
-        }
-    next3:
-        // process second line until y value is about to change
-        while (t2x != x3) {
-            e2 += dy2;
-            while (e2 >= dx2) {
-                e2 -= dx2;
-                if (changed2) t2xp = signx2;
-                else          goto next4;
+            for (int copy = top + 1; copy < bottom; ++copy) {
+                std::copy_n(destination, console_dimensions_.x, upscaled_.row(copy));
             }
-            if (changed2)     break;
-            else              t2x += signx2;
         }
-    next4:
-
-        if (minx > t1x) minx = t1x; if (minx > t2x) minx = t2x;
-        if (maxx < t1x) maxx = t1x; if (maxx < t2x) maxx = t2x;
-        drawline(minx, maxx, y);
-        if (!changed1) t1x += signx1;
-        t1x += t1xp;
-        if (!changed2) t2x += signx2;
-        t2x += t2xp;
-        y += 1;
-        if (y > y3) return;
-    }
-}
-
-void ConsoleGraphicsEngine::draw_circle(const Coordinate<int>& centre, const int radius, const Pixel& pixel) {
-    Coordinate<int> current = { 0, radius };
-    int p = 1 - radius;
-    while (current.x <= current.y) {
-        draw_pixel(centre + current, pixel);
-        draw_pixel(centre - current, pixel);
-        draw_pixel(centre + Coordinate<int>(current.y, current.x), pixel);
-        draw_pixel(centre - Coordinate<int>(current.y, current.x), pixel);
-        draw_pixel(centre + Coordinate<int>(-current.x, current.y), pixel);
-        draw_pixel(centre - Coordinate<int>(-current.x, current.y), pixel);
-        draw_pixel(centre + Coordinate<int>(current.x, -current.y), pixel);
-        draw_pixel(centre - Coordinate<int>(current.x, -current.y), pixel);
-        if (p < 0) {
-            p += 2 * current.x + 3;
-        } else {
-            p += 2 * (current.x - current.y) + 5;
-            --current.y;
-        }
-        ++current.x;
-    }
+    }, 4);
+    return upscaled_;
 }
 
-void ConsoleGraphicsEngine::draw_filled_circle(const Coordinate<int>& centre, const int radius, const Pixel& pixel) {
-    Coordinate<int> current = { 0, radius };
-    int p = 1 - radius;
-    while (current.x <= current.y) {
-        draw_line(centre + Coordinate<int>(-current.y, current.x), centre + Coordinate<int>(current.y, current.x), pixel);
-        draw_line(centre + Coordinate<int>(-current.x, current.y), centre + current, pixel);
-        draw_line(centre - current, centre + Coordinate<int>(current.x, -current.y), pixel);
-        draw_line(centre + Coordinate<int>(-current.y, -current.x), centre + Coordinate<int>(current.y, -current.x), pixel);
-        if (p < 0) {
-            p += 2 * current.x + 3;
-        } else {
-            p += 2 * (current.x - current.y) + 5;
-            --current.y;
-        }
-        ++current.x;
+void ConsoleGraphicsEngine::report_allocations(const size_t allocations) {
+    constexpr size_t warm_up_frames = 120;
+    frame_allocations_ = allocations;
+    if (++frame_ <= warm_up_frames or allocations == 0) {
+        return;
     }
+    std::array<char, 96> message;
+    *std::format_to_n(message.data(), message.size() - 1, "Frame {}: {} heap allocations after warm up\n", frame_, allocations).out = '\0';
+    OutputDebugStringA(message.data());
 }
 
-void ConsoleGraphicsEngine::draw_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel& pixel) {
-    Coordinate<int> current;
-    for (current.x = top_left.x; current.x <= bottom_right.x; ++current.x) {
-        for (current.y = top_left.y; current.y <= bottom_right.y; ++current.y) {
-            if (current.x == top_left.x or current.x == bottom_right.x or
-                current.y == top_left.y or current.y == bottom_right.y) {
-                draw_pixel(current, pixel);
-            }
-        }
-    }
+
+
+// Drawing functions
+
+
+void ConsoleGraphicsEngine::clear_screen(const Pixel& pixel) {
+    const CHAR_INFO cell = pixel.char_info();
+    jobs_.parallel_for(0, dimensions_.y, [&](const int first, const int last) {
+        std::fill(row(first), row(last), cell);
+    }, 16);
 }
 
-void ConsoleGraphicsEngine::draw_filled_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel& pixel) {
-    Coordinate<int> current;
-    for (current.x = top_left.x; current.x <= bottom_right.x; ++current.x) {
-        for (current.y = top_left.y; current.y <= bottom_right.y; ++current.y) {
-            draw_pixel(current, pixel);
+void ConsoleGraphicsEngine::blit(const Coordinate<int>& coordinate, const SpriteView& source) {
+    Coordinate<int> begin, end;
+    if (not clip(coordinate, source.dimensions(), begin, end)) {
+        return;
+    }
+    const size_t length = static_cast<size_t>(end.x - begin.x);
+    jobs_.parallel_for(begin.y, end.y, [&](const int first, const int last) {
+        for (int y = first; y < last; ++y) {
+            std::copy_n(source.row(y) + begin.x, length, row(coordinate.y + y) + coordinate.x + begin.x);
         }
+    }, 16);
+}
+
+void ConsoleGraphicsEngine::scroll(const Coordinate<int>& position, const Coordinate<int>& dimensions, const Coordinate<int>& delta, const Pixel& pixel) {
+    Surface::scroll(position, dimensions, delta, pixel);
+    // Headless replays never render, so nothing would consume the queue
+    Coordinate<int> begin, end;
+    if (not replay_ and scaler_.divisor() == 1 and clip(position, dimensions, begin, end)) {
+        const Coordinate<int> top_left = position + begin, bottom_right = position + end - Coordinate<int>(1, 1);
+        scrolls_.push_back({
+            { static_cast<SHORT>(top_left.x), static_cast<SHORT>(top_left.y), static_cast<SHORT>(bottom_right.x), static_cast<SHORT>(bottom_right.y) },
+            delta,
+            pixel.char_info(),
+        });
     }
 }
 
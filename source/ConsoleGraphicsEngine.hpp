@@ -3,8 +3,34 @@
 #include "pch.hpp"
 
 #include "Coordinate.hpp"
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "CoordinateBuffer.hpp"
 #include "Pixel.hpp"
+#include "Surface.hpp"
+#include "Blend.hpp"
 #include "Sprite.hpp"
+#include "SpriteView.hpp"
+#include "SpriteAtlas.hpp"
+#include "Text.hpp"
+#include "BitmapFont.hpp"
+#include "Animation.hpp"
+#include "CollisionMask.hpp"
+#include "SpatialGrid.hpp"
+#include "Tilemap.hpp"
+#include "Image.hpp"
+#include "Raycaster.hpp"
+#include "JobSystem.hpp"
+#include "FrameArena.hpp"
+#include "ResolutionScaler.hpp"
+#include "InputRecording.hpp"
+#include "FrameRecording.hpp"
+#include "FrameExport.hpp"
+#include "Allocations.hpp"
+#include "AssetManager.hpp"
+#include "PostProcess.hpp"
+#include "World.hpp"
+#include "ParticleSystem.hpp"
 
 
 class Timer {
@@ -25,7 +51,7 @@ private:
 };
 
 
-class ConsoleGraphicsEngine {
+class ConsoleGraphicsEngine : protected Surface {
 public:
 
     ConsoleGraphicsEngine() = delete;
@@ -35,6 +61,9 @@ public:
     ConsoleGraphicsEngine& operator=(ConsoleGraphicsEngine&&) = delete;
 
     explicit ConsoleGraphicsEngine(const Coordinate<int>& screen_dimensions = { 80, 40 }, const Coordinate<int>& font_dimensions = { 8, 8 }, const std::string& title = "Console Graphics Engine");
+    // Headless: plays back a recording made with record() instead of reading input, and never touches the console.
+    // Unless real_time, frames run back to back; the engine stops when the recording runs out.
+    ConsoleGraphicsEngine(const Coordinate<int>& screen_dimensions, const std::string& replay_filename, bool real_time = false);
 
     virtual ~ConsoleGraphicsEngine();
 
@@ -42,6 +71,22 @@ public:
 
     void run();
 
+    // Logs every frame's time and input from the next frame on, for replaying later
+    void record(const std::string& filename);
+
+    // Time each replayed frame took to run, in seconds, for comparing builds on the same workload
+    [[nodiscard]] const std::vector<double>& replay_frame_times() const;
+
+    // Writes every presented frame to a compressed recording from the next frame on, headless runs included
+    void record_frames(const std::string& filename, int keyframe_interval = 600);
+
+    // Presents a frame recording instead of the screen, at its recorded pace times the player's speed. Update still
+    // runs, so it can seek and change the speed; the last frame stays up once the recording has run out.
+    FramePlayer& play_frames(const std::string& filename);
+
+    // Publishes every presented frame into a shared memory ring named name, for FrameExportReader in other processes
+    void export_frames(const std::string& name = "ConsoleGraphicsEngine", int slots = 4);
+
 protected:
 
     virtual void initialise();
@@ -125,45 +170,63 @@ protected:
     };
 
 
+    // Dimensions drawn into, which shrink while the resolution is scaled down
     [[nodiscard]] const Coordinate<int>& screen_dimensions() const;
     [[nodiscard]] int screen_width() const;
     [[nodiscard]] int screen_height() const;
 
     [[nodiscard]] static bool is_active();
 
-    [[nodiscard]] static ButtonState key(Key);
-    [[nodiscard]] static ButtonState key(char key);
+    // Input is sampled once at the start of every frame
+    [[nodiscard]] ButtonState key(Key) const;
+    [[nodiscard]] ButtonState key(char key) const;
 
-    [[nodiscard]] static ButtonState mouse_button(MouseButton);
+    [[nodiscard]] ButtonState mouse_button(MouseButton) const;
 
-    const Coordinate<int>& mouse_position();
-    int mouse_x();
-    int mouse_y();
+    // In screen cells, so scaled down along with the resolution
+    [[nodiscard]] Coordinate<int> mouse_position() const;
+    [[nodiscard]] int mouse_x() const;
+    [[nodiscard]] int mouse_y() const;
 
     // MouseWheelState mouse_wheel();
 
 
-    void clear_screen(const Pixel & = Pixel::Colour::Black);
+    [[nodiscard]] Surface& screen();
+
+    // Shared by all CPU work in a frame, the engine's own included
+    [[nodiscard]] JobSystem& jobs();
 
-    void draw_character(const Coordinate<int>&, const WCHAR character, const Pixel::Colour = Pixel::Colour::White);
+    // Scratch memory for the current frame, reset before every update
+    [[nodiscard]] FrameArena& frame_arena();
 
-    void draw_pixel(const Coordinate<int>&, const Pixel & = Pixel::Colour::White);
+    // Renders at 1/2 or 1/4 resolution per axis, upscaled to the console, while frames take longer than the budget in
+    // seconds. Zero, the default, keeps full resolution. Screen dimensions change between frames when it scales.
+    void set_frame_budget(double seconds);
+    [[nodiscard]] int resolution_divisor() const;
 
-    void draw_sprite(const Coordinate<int>&, const Sprite&, const int scale = 1);
+    // Heap allocations made by the thread running run() during the last frame, counted in builds defining
+    // CGE_COUNT_ALLOCATIONS; jobs run on worker threads are not counted. Frames after the warm up that allocate are
+    // reported to the debugger output.
+    [[nodiscard]] size_t frame_allocations() const;
 
-    void draw_string(const Coordinate<int>&, const std::wstring&, Pixel::Colour = Pixel::Colour::White);
-    void draw_string(const Coordinate<int>&, const std::string&, Pixel::Colour = Pixel::Colour::White);
+    [[nodiscard]] AssetManager& assets();
 
-    void draw_line(const Coordinate<int>& start, const Coordinate<int>& stop, const Pixel & = Pixel::Colour::White);
+    // Run over the screen after every update, before it is rendered
+    [[nodiscard]] PostProcess& post_process();
 
-    void draw_triangle(const std::array<Coordinate<int>, 3>&, const Pixel & = Pixel::Colour::White);
-    void draw_filled_triangle(const std::array<Coordinate<int>, 3>&, const Pixel & = Pixel::Colour::White);
+    // Systems run before every update; draw its entities with world().draw(screen())
+    [[nodiscard]] World& world();
 
-    void draw_circle(const Coordinate<int>& centre, const int radius = 1, const Pixel & = Pixel::Colour::White);
-    void draw_filled_circle(const Coordinate<int>& centre, const int radius = 1, const Pixel & = Pixel::Colour::White);
+    // Updated before every update; draw its particles with particles().draw(screen())
+    [[nodiscard]] ParticleSystem& particles();
+
+    void clear_screen(const Pixel & = Pixel::Colour::Black);
 
-    void draw_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel & = Pixel::Colour::White);
-    void draw_filled_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel & = Pixel::Colour::White);
+    // Surface::blit, split into bands of rows across the job system
+    void blit(const Coordinate<int>&, const SpriteView&);
+
+    // Surface::scroll, also replayed on the console at the next render so the moved rows are not written again
+    void scroll(const Coordinate<int>& position, const Coordinate<int>& dimensions, const Coordinate<int>& delta, const Pixel & = Pixel::Colour::Black);
 
 private:
 
@@ -173,22 +236,65 @@ private:
         HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
         HANDLE original = nullptr;
     } console_;
-    Coordinate<int> mouse_position_ = { 0, 0 };
+    InputState input_, previous_input_;
+    std::unique_ptr<InputRecorder> recorder_;
+    std::unique_ptr<InputReplay> replay_;
+    bool real_time_ = false;
+    std::vector<double> replay_frame_times_;
+    std::unique_ptr<FrameRecorder> frame_recorder_;
+    std::unique_ptr<FramePlayer> frame_player_;
+    std::unique_ptr<FrameExporter> frame_exporter_;
 
-    const Coordinate<int> screen_dimensions_;
     const std::string title_;
-    std::vector<CHAR_INFO> buffer_;
+    std::string window_title_;
     const std::unique_ptr<SMALL_RECT> window_region_;
 
+    JobSystem jobs_;
+    FrameArena frame_arena_;
+    AssetManager assets_;
+    PostProcess post_process_;
+    World world_;
+    ParticleSystem particles_;
+
+    struct Scroll {
+        SMALL_RECT region;
+        Coordinate<int> delta;
+        CHAR_INFO fill;
+    };
+
+    const Coordinate<int> console_dimensions_;
+    ResolutionScaler scaler_;
+    // The screen upscaled to the console's dimensions, while the resolution is scaled down
+    Surface upscaled_;
+
+    // What the console currently shows, so render() only writes the rows that changed
+    Surface presented_;
+    bool presented_valid_ = false;
+    std::vector<char> dirty_;
+    std::vector<Scroll> scrolls_;
+
+    size_t frame_ = 0;
+    size_t frame_allocations_ = 0;
+
     inline static std::atomic<bool> active_ = false;
     inline static std::mutex mutex_ = std::mutex();
     inline static std::condition_variable game_finished_ = std::condition_variable();
 
-    void render(double frame_rate) const;
-
-    [[nodiscard]] static ButtonState button(char button);
-
-    [[nodiscard]] std::vector<INPUT_RECORD> input_record() const;
+    void render(double frame_time);
+    // What render presents: the screen, upscaled to the console, or the frame recording played
+    const Surface& presented_frame();
+    // Hands the presented frame to the frame recorder and exporter
+    void capture(double frame_time, const Surface& frame);
+    void report_allocations(size_t allocations);
+    void rescale();
+    const Surface& upscale();
+
+    [[nodiscard]] ButtonState button(char button) const;
+    // Samples live input, or takes the next frame of the replay along with its frame time
+    bool poll_input(double& frame_time);
+
+    // Allocated in the frame arena
+    [[nodiscard]] std::span<const INPUT_RECORD> input_record();
 
     static BOOL close_handler(DWORD event);
 };
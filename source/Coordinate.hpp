@@ -8,43 +8,53 @@ struct Coordinate {
 
     type x, y;
 
-    Coordinate() : x(static_cast<type>(0)), y(static_cast<type>(0)) {}
-    Coordinate(type x, type y) : x(x), y(y) {}
-    Coordinate(const std::initializer_list<type>& list) : x(*list.begin()), y(*(list.begin() + 1)) {}
+    constexpr Coordinate() : x(static_cast<type>(0)), y(static_cast<type>(0)) {}
+    constexpr Coordinate(type x, type y) : x(x), y(y) {}
+    constexpr Coordinate(const std::initializer_list<type>& list) : x(*list.begin()), y(*(list.begin() + 1)) {}
 
-    Coordinate& operator-() { x = -x; y = -y; return *this; }
+    constexpr Coordinate operator-() const { return { -x, -y }; }
 
-    Coordinate& operator+=(const Coordinate& other) { return *this = *this + other; }
-    Coordinate& operator-=(const Coordinate& other) { return *this = *this - other; }
-    Coordinate& operator*=(const Coordinate& other) { return *this = *this * other; }
-    Coordinate& operator/=(const Coordinate& other) { return *this = *this / other; }
+    constexpr Coordinate& operator+=(const Coordinate& other) { return *this = *this + other; }
+    constexpr Coordinate& operator-=(const Coordinate& other) { return *this = *this - other; }
+    constexpr Coordinate& operator*=(const Coordinate& other) { return *this = *this * other; }
+    constexpr Coordinate& operator/=(const Coordinate& other) { return *this = *this / other; }
 
-    Coordinate& operator*=(const type scalar) { return *this = *this * scalar; }
-    Coordinate& operator/=(const type scalar) { return *this = *this / scalar; }
+    constexpr Coordinate& operator*=(const type scalar) { return *this = *this * scalar; }
+    constexpr Coordinate& operator/=(const type scalar) { return *this = *this / scalar; }
 
-    bool in_bounds(const Coordinate& dimensions) const { return *this >= Coordinate(0, 0) and *this < dimensions; }
-    size_t to_index(const int width) const { return y * static_cast<size_t>(width) + x; }
+    constexpr bool in_bounds(const Coordinate& dimensions) const { return *this >= Coordinate(0, 0) and *this < dimensions; }
+    constexpr size_t to_index(const int width) const { return y * static_cast<size_t>(width) + x; }
 
-    friend Coordinate operator+(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y }; }
-    friend Coordinate operator-(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y }; }
-    friend Coordinate operator*(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y }; }
-    friend Coordinate operator/(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y }; }
+    friend constexpr Coordinate operator+(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y }; }
+    friend constexpr Coordinate operator-(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y }; }
+    friend constexpr Coordinate operator*(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y }; }
+    friend constexpr Coordinate operator/(const Coordinate& lhs, const Coordinate& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y }; }
 
-    friend Coordinate operator*(const Coordinate& lhs, const type rhs) { return { lhs.x * rhs, lhs.y * rhs }; }
-    friend Coordinate operator*(const type lhs, const Coordinate& rhs) { return rhs * lhs; }
-    friend Coordinate operator/(const Coordinate& lhs, const type rhs) { return { lhs.x / rhs, lhs.y / rhs }; }
+    friend constexpr Coordinate operator*(const Coordinate& lhs, const type rhs) { return { lhs.x * rhs, lhs.y * rhs }; }
+    friend constexpr Coordinate operator*(const type lhs, const Coordinate& rhs) { return rhs * lhs; }
+    friend constexpr Coordinate operator/(const Coordinate& lhs, const type rhs) { return { lhs.x / rhs, lhs.y / rhs }; }
 
-    friend bool operator< (const Coordinate& lhs, const Coordinate& rhs) { return lhs.x < rhs.x and lhs.y < rhs.y; }
-    friend bool operator<=(const Coordinate& lhs, const Coordinate& rhs) { return lhs.x <= rhs.x and lhs.y <= rhs.y; }
-    friend bool operator==(const Coordinate& lhs, const Coordinate& rhs) = default;
-    friend bool operator>=(const Coordinate& lhs, const Coordinate& rhs) { return lhs.x >= rhs.x and lhs.y >= rhs.y; }
-    friend bool operator> (const Coordinate& lhs, const Coordinate& rhs) { return lhs.x > rhs.x and lhs.y > rhs.y; }
+    friend constexpr bool operator< (const Coordinate& lhs, const Coordinate& rhs) { return lhs.x < rhs.x and lhs.y < rhs.y; }
+    friend constexpr bool operator<=(const Coordinate& lhs, const Coordinate& rhs) { return lhs.x <= rhs.x and lhs.y <= rhs.y; }
+    friend constexpr bool operator==(const Coordinate& lhs, const Coordinate& rhs) = default;
+    friend constexpr bool operator>=(const Coordinate& lhs, const Coordinate& rhs) { return lhs.x >= rhs.x and lhs.y >= rhs.y; }
+    friend constexpr bool operator> (const Coordinate& lhs, const Coordinate& rhs) { return lhs.x > rhs.x and lhs.y > rhs.y; }
 
     friend std::ostream& operator<<(std::ostream& stream, const Coordinate& coordinate) { return stream << coordinate.x << ' ' << coordinate.y; }
     friend std::istream& operator>>(std::istream& stream, Coordinate& coordinate) { return stream >> coordinate.x >> coordinate.y; }
 
     template <typename type2>
-    explicit operator Coordinate<type2>() const {
+    constexpr explicit operator Coordinate<type2>() const {
         return { static_cast<type2>(x), static_cast<type2>(y) };
     }
-};
\ No newline at end of file
+};
+
+
+template <typename type>
+constexpr type dot(const Coordinate<type>& lhs, const Coordinate<type>& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y; }
+
+template <typename type>
+constexpr type cross(const Coordinate<type>& lhs, const Coordinate<type>& rhs) { return lhs.x * rhs.y - lhs.y * rhs.x; }
+
+template <typename type>
+type length(const Coordinate<type>& coordinate) { return static_cast<type>(std::sqrt(dot(coordinate, coordinate))); }
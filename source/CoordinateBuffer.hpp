@@ -0,0 +1,135 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Vector.hpp"
+#include "Matrix.hpp"
+
+
+// Structure-of-arrays storage, so batch transforms stream through contiguous components and auto-vectorise
+template <typename type>
+struct CoordinateBuffer {
+
+    std::vector<type> x, y;
+
+    CoordinateBuffer() = default;
+    explicit CoordinateBuffer(const size_t size) : x(size), y(size) {}
+
+    size_t size() const { return x.size(); }
+    void resize(const size_t size) { x.resize(size); y.resize(size); }
+    void reserve(const size_t capacity) { x.reserve(capacity); y.reserve(capacity); }
+    void clear() { x.clear(); y.clear(); }
+
+    void push_back(const Coordinate<type>& coordinate) { x.push_back(coordinate.x); y.push_back(coordinate.y); }
+
+    Coordinate<type> operator[](const size_t index) const { return { x[index], y[index] }; }
+    void set(const size_t index, const Coordinate<type>& coordinate) { x[index] = coordinate.x; y[index] = coordinate.y; }
+};
+
+
+template <typename type>
+struct Vector3Buffer {
+
+    std::vector<type> x, y, z;
+
+    Vector3Buffer() = default;
+    explicit Vector3Buffer(const size_t size) : x(size), y(size), z(size) {}
+
+    size_t size() const { return x.size(); }
+    void resize(const size_t size) { x.resize(size); y.resize(size); z.resize(size); }
+    void reserve(const size_t capacity) { x.reserve(capacity); y.reserve(capacity); z.reserve(capacity); }
+    void clear() { x.clear(); y.clear(); z.clear(); }
+
+    void push_back(const Vector3<type>& vector) { x.push_back(vector.x); y.push_back(vector.y); z.push_back(vector.z); }
+
+    Vector3<type> operator[](const size_t index) const { return { x[index], y[index], z[index] }; }
+    void set(const size_t index, const Vector3<type>& vector) { x[index] = vector.x; y[index] = vector.y; z[index] = vector.z; }
+};
+
+
+// Batch transforms. The matrix is copied into locals so the loops carry no dependencies and compile to packed SIMD.
+// transform() may be called in place (output == input).
+
+template <typename type>
+void transform(const Matrix3<type>& matrix, const CoordinateBuffer<type>& input, CoordinateBuffer<type>& output) {
+    output.resize(input.size());
+    const type m00 = matrix(0, 0), m01 = matrix(0, 1), m02 = matrix(0, 2);
+    const type m10 = matrix(1, 0), m11 = matrix(1, 1), m12 = matrix(1, 2);
+    const size_t size = input.size();
+    if (&input == &output) {
+        type* __restrict x = output.x.data();
+        type* __restrict y = output.y.data();
+        for (size_t i = 0; i < size; ++i) {
+            const type input_x = x[i], input_y = y[i];
+            x[i] = m00 * input_x + m01 * input_y + m02;
+            y[i] = m10 * input_x + m11 * input_y + m12;
+        }
+    } else {
+        const type* __restrict input_x = input.x.data();
+        const type* __restrict input_y = input.y.data();
+        type* __restrict output_x = output.x.data();
+        type* __restrict output_y = output.y.data();
+        for (size_t i = 0; i < size; ++i) {
+            output_x[i] = m00 * input_x[i] + m01 * input_y[i] + m02;
+            output_y[i] = m10 * input_x[i] + m11 * input_y[i] + m12;
+        }
+    }
+}
+
+template <typename type>
+void transform(const Matrix4<type>& matrix, const Vector3Buffer<type>& input, Vector3Buffer<type>& output) {
+    output.resize(input.size());
+    const type m00 = matrix(0, 0), m01 = matrix(0, 1), m02 = matrix(0, 2), m03 = matrix(0, 3);
+    const type m10 = matrix(1, 0), m11 = matrix(1, 1), m12 = matrix(1, 2), m13 = matrix(1, 3);
+    const type m20 = matrix(2, 0), m21 = matrix(2, 1), m22 = matrix(2, 2), m23 = matrix(2, 3);
+    const size_t size = input.size();
+    const type* input_x = input.x.data();
+    const type* input_y = input.y.data();
+    const type* input_z = input.z.data();
+    type* output_x = output.x.data();
+    type* output_y = output.y.data();
+    type* output_z = output.z.data();
+    for (size_t i = 0; i < size; ++i) {
+        const type x = input_x[i], y = input_y[i], z = input_z[i];
+        output_x[i] = m00 * x + m01 * y + m02 * z + m03;
+        output_y[i] = m10 * x + m11 * y + m12 * z + m13;
+        output_z[i] = m20 * x + m21 * y + m22 * z + m23;
+    }
+}
+
+// Transforms with the perspective divide and drops depth, e.g. with viewport * perspective * view
+template <typename type>
+void project(const Matrix4<type>& matrix, const Vector3Buffer<type>& input, CoordinateBuffer<type>& output) {
+    output.resize(input.size());
+    const type m00 = matrix(0, 0), m01 = matrix(0, 1), m02 = matrix(0, 2), m03 = matrix(0, 3);
+    const type m10 = matrix(1, 0), m11 = matrix(1, 1), m12 = matrix(1, 2), m13 = matrix(1, 3);
+    const type m30 = matrix(3, 0), m31 = matrix(3, 1), m32 = matrix(3, 2), m33 = matrix(3, 3);
+    const size_t size = input.size();
+    const type* __restrict input_x = input.x.data();
+    const type* __restrict input_y = input.y.data();
+    const type* __restrict input_z = input.z.data();
+    type* __restrict output_x = output.x.data();
+    type* __restrict output_y = output.y.data();
+    for (size_t i = 0; i < size; ++i) {
+        const type x = input_x[i], y = input_y[i], z = input_z[i];
+        const type w = m30 * x + m31 * y + m32 * z + m33;
+        output_x[i] = (m00 * x + m01 * y + m02 * z + m03) / w;
+        output_y[i] = (m10 * x + m11 * y + m12 * z + m13) / w;
+    }
+}
+
+// Rounds to the nearest cell coordinates ready for drawing, halves upwards, negative coordinates included
+template <typename type>
+void to_cells(const CoordinateBuffer<type>& input, CoordinateBuffer<int>& output) {
+    output.resize(input.size());
+    const size_t size = input.size();
+    const type* __restrict input_x = input.x.data();
+    const type* __restrict input_y = input.y.data();
+    int* __restrict output_x = output.x.data();
+    int* __restrict output_y = output.y.data();
+    for (size_t i = 0; i < size; ++i) {
+        output_x[i] = static_cast<int>(std::floor(input_x[i] + static_cast<type>(0.5)));
+        output_y[i] = static_cast<int>(std::floor(input_y[i] + static_cast<type>(0.5)));
+    }
+}
@@ -0,0 +1,161 @@
+#include "pch.hpp"
+
+#include "FileWatcher.hpp"
+
+
+FileWatcher::FileWatcher(const Callback& callback) : callback_(callback), wake_(CreateEventW(nullptr, FALSE, FALSE, nullptr)) {
+    if (wake_ == nullptr) {
+        throw std::runtime_error("Failed to create file watcher event");
+    }
+    thread_ = std::thread(&FileWatcher::run, this);
+}
+
+FileWatcher::~FileWatcher() {
+    stopping_ = true;
+    SetEvent(wake_);
+    thread_.join();
+    for (const auto& directory : directories_) {
+        DWORD bytes = 0;
+        CancelIoEx(directory->handle, &directory->overlapped);
+        GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+        CloseHandle(directory->overlapped.hEvent);
+        CloseHandle(directory->handle);
+    }
+    CloseHandle(wake_);
+}
+
+
+void FileWatcher::watch(const std::filesystem::path& directory) {
+    const std::filesystem::path path = std::filesystem::absolute(directory).lexically_normal();
+    {
+        std::lock_guard lock(mutex_);
+        if (std::find(watched_.begin(), watched_.end(), path) != watched_.end()) {
+            return;
+        }
+        // One wait handle is the wake event
+        if (watched_.size() + 1 >= MAXIMUM_WAIT_OBJECTS) {
+            throw std::runtime_error("Unable to watch more than " + std::to_string(MAXIMUM_WAIT_OBJECTS - 1) + " directories");
+        }
+        watched_.push_back(path);
+        added_.push_back(path);
+    }
+    SetEvent(wake_);
+}
+
+
+void FileWatcher::run() {
+    std::vector<HANDLE> events;
+    while (not stopping_) {
+        {
+            std::lock_guard lock(mutex_);
+            for (const auto& directory : added_) {
+                if (not open(directory)) {
+                    watched_.erase(std::find(watched_.begin(), watched_.end(), directory));
+                }
+            }
+            added_.clear();
+        }
+
+        events.assign(1, wake_);
+        for (const auto& directory : directories_) {
+            events.push_back(directory->overlapped.hEvent);
+        }
+
+        const DWORD result = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0) {
+            continue;
+        }
+        // Only an invalid handle fails the wait, and it fails every wait after, so the directories whose own events
+        // fail are dropped; if none do, the wake event is the invalid one and the watcher stops
+        if (result == WAIT_FAILED or result >= WAIT_OBJECT_0 + events.size()) {
+            bool dropped = false;
+            for (size_t index = directories_.size(); index-- > 0;) {
+                if (WaitForSingleObject(directories_[index]->overlapped.hEvent, 0) == WAIT_FAILED) {
+                    close(index);
+                    dropped = true;
+                }
+            }
+            if (not dropped) {
+                return;
+            }
+            continue;
+        }
+
+        const size_t index = result - WAIT_OBJECT_0 - 1;
+        Directory& directory = *directories_[index];
+        DWORD bytes = 0;
+        if (GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, FALSE)) {
+            dispatch(directory, bytes);
+        }
+        // A directory that cannot be listened to again, such as one deleted, would leave its event signalled and
+        // the loop spinning, so it stops being watched; watching it again retries
+        if (not listen(directory)) {
+            close(index);
+        }
+    }
+}
+
+bool FileWatcher::open(const std::filesystem::path& path) {
+    auto directory = std::make_unique<Directory>();
+    directory->path = path;
+    directory->handle = CreateFileW(
+        path.wstring().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr
+    );
+    if (directory->handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    directory->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (directory->overlapped.hEvent == nullptr) {
+        CloseHandle(directory->handle);
+        return false;
+    }
+    if (not listen(*directory)) {
+        CloseHandle(directory->overlapped.hEvent);
+        CloseHandle(directory->handle);
+        return false;
+    }
+    directories_.push_back(std::move(directory));
+    return true;
+}
+
+void FileWatcher::close(const size_t index) {
+    Directory& directory = *directories_[index];
+    {
+        std::lock_guard lock(mutex_);
+        watched_.erase(std::find(watched_.begin(), watched_.end(), directory.path));
+    }
+    DWORD bytes = 0;
+    CancelIoEx(directory.handle, &directory.overlapped);
+    GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, TRUE);
+    CloseHandle(directory.overlapped.hEvent);
+    CloseHandle(directory.handle);
+    directories_.erase(directories_.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+bool FileWatcher::listen(Directory& directory) {
+    HANDLE event = directory.overlapped.hEvent;
+    directory.overlapped = {};
+    directory.overlapped.hEvent = event;
+    return ReadDirectoryChangesW(
+        directory.handle, directory.buffer.data(), static_cast<DWORD>(directory.buffer.size() * sizeof(DWORD)), FALSE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, &directory.overlapped, nullptr
+    );
+}
+
+void FileWatcher::dispatch(const Directory& directory, const DWORD bytes) const {
+    if (bytes == 0) {
+        return;
+    }
+    const auto* buffer = reinterpret_cast<const BYTE*>(directory.buffer.data());
+    for (DWORD offset = 0;;) {
+        const auto* information = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer + offset);
+        if (information->Action == FILE_ACTION_MODIFIED or information->Action == FILE_ACTION_ADDED or information->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+            callback_(directory.path / std::wstring(information->FileName, information->FileNameLength / sizeof(WCHAR)));
+        }
+        if (information->NextEntryOffset == 0) {
+            break;
+        }
+        offset += information->NextEntryOffset;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Watches directories for files written, created or renamed into place, reporting each on a background thread
+class FileWatcher {
+public:
+
+    using Callback = std::function<void(const std::filesystem::path&)>;
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher(FileWatcher&&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    FileWatcher& operator=(FileWatcher&&) = delete;
+
+    explicit FileWatcher(const Callback& callback);
+
+    ~FileWatcher();
+
+    // Throws once MAXIMUM_WAIT_OBJECTS - 1 directories are watched. Directories that cannot be opened, or stop being
+    // readable, are forgotten, so watching them again retries.
+    void watch(const std::filesystem::path& directory);
+
+private:
+
+    struct Directory {
+        std::filesystem::path path;
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        std::array<DWORD, 4096> buffer = {};
+    };
+
+    const Callback callback_;
+    const HANDLE wake_;
+    std::atomic<bool> stopping_ = false;
+
+    std::mutex mutex_;
+    std::vector<std::filesystem::path> added_;
+    std::vector<std::filesystem::path> watched_;
+
+    std::vector<std::unique_ptr<Directory>> directories_;
+    std::thread thread_;
+
+    void run();
+    bool open(const std::filesystem::path& directory);
+    void close(size_t index);
+    bool listen(Directory& directory);
+    void dispatch(const Directory& directory, DWORD bytes) const;
+};
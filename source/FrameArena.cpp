@@ -0,0 +1,45 @@
+#include "pch.hpp"
+
+#include "FrameArena.hpp"
+
+
+FrameArena::FrameArena(const size_t capacity) : block_(std::make_unique<std::byte[]>(capacity)), capacity_(capacity) {}
+
+void FrameArena::reset() {
+    if (not overflow_.empty()) {
+        capacity_ += overflow_size_;
+        block_ = std::make_unique<std::byte[]>(capacity_);
+        overflow_.clear();
+        overflow_size_ = 0;
+    }
+    used_ = 0;
+}
+
+size_t FrameArena::used() const {
+    return used_ + overflow_size_;
+}
+
+size_t FrameArena::capacity() const {
+    return capacity_;
+}
+
+
+void* FrameArena::do_allocate(const size_t bytes, const size_t alignment) {
+    void* pointer = block_.get() + used_;
+    size_t space = capacity_ - used_;
+    if (std::align(alignment, bytes, pointer, space)) {
+        used_ = capacity_ - space + bytes;
+        return pointer;
+    }
+    space = bytes + alignment;
+    overflow_.push_back(std::make_unique<std::byte[]>(space));
+    overflow_size_ += space;
+    pointer = overflow_.back().get();
+    return std::align(alignment, bytes, pointer, space);
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t) {}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
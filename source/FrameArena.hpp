@@ -0,0 +1,50 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Bump allocator for memory that only lives until the end of the frame. Allocating is a pointer increment and reset()
+// releases everything at once; deallocation does nothing. A frame needing more than the capacity takes the rest from
+// the heap, and the next reset grows the block so that later frames fit. Usable as a memory resource for std::pmr
+// containers. Not thread safe.
+class FrameArena : public std::pmr::memory_resource {
+public:
+
+    explicit FrameArena(size_t capacity = 1 << 20);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Constructs an object in the arena; its destructor is never run
+    template <typename type, typename... Arguments>
+    type* create(Arguments&&... arguments) {
+        static_assert(std::is_trivially_destructible_v<type>, "Objects in a frame arena are never destroyed");
+        return new (allocate(sizeof(type), alignof(type))) type(std::forward<Arguments>(arguments)...);
+    }
+
+    // Value initialised array in the arena
+    template <typename type>
+    std::span<type> array(const size_t count) {
+        static_assert(std::is_trivially_destructible_v<type>, "Objects in a frame arena are never destroyed");
+        type* elements = static_cast<type*>(allocate(count * sizeof(type), alignof(type)));
+        std::uninitialized_value_construct_n(elements, count);
+        return { elements, count };
+    }
+
+    void reset();
+
+    [[nodiscard]] size_t used() const;
+    [[nodiscard]] size_t capacity() const;
+
+private:
+
+    std::unique_ptr<std::byte[]> block_;
+    size_t capacity_;
+    size_t used_ = 0;
+    std::vector<std::unique_ptr<std::byte[]>> overflow_;
+    size_t overflow_size_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override;
+    bool do_is_equal(const std::pmr::memory_resource&) const noexcept override;
+};
@@ -0,0 +1,229 @@
+#include "pch.hpp"
+
+#include "FrameExport.hpp"
+
+
+namespace {
+
+    constexpr std::array<char, 4> magic = { 'C', 'G', 'E', 'S' };
+    constexpr uint32_t version = 1;
+
+    // The header and every slot start on their own cache line, so the engine writing one slot does not slow readers
+    // of the others
+    constexpr size_t line = 64;
+
+    // Written once before version, which readers check first
+    struct Header {
+        std::array<char, 4> magic;
+        alignas(4) uint32_t version;
+        int32_t width, height;
+        int32_t slots;
+        uint32_t cell_size;
+        // Frames published, only accessed atomically
+        alignas(8) uint64_t published;
+    };
+
+    // Followed by the frame's cells on the next line; all fields only accessed atomically
+    struct Slot {
+        // Odd while the slot is being written
+        alignas(8) uint64_t sequence;
+        uint64_t frame;
+        double frame_time;
+    };
+
+    static_assert(sizeof(Header) <= line and sizeof(Slot) <= line);
+
+    size_t cells_size(const Coordinate<int>& dimensions) {
+        return static_cast<size_t>(dimensions.x) * dimensions.y * sizeof(CHAR_INFO);
+    }
+
+    size_t frame_size(const Coordinate<int>& dimensions) {
+        return (cells_size(dimensions) + line - 1) / line * line;
+    }
+
+    size_t slot_offset(const Coordinate<int>& dimensions, const size_t slot) {
+        return line + slot * (line + frame_size(dimensions));
+    }
+
+    template <typename type>
+    std::atomic_ref<type> atomic(const type& value) {
+        // Readers only load through the reference, so read only mappings are never written
+        return std::atomic_ref<type>(const_cast<type&>(value));
+    }
+}
+
+
+FrameExporter::FrameExporter(const std::string& name, const Coordinate<int>& dimensions, const int slots) : dimensions_(dimensions), slots_(slots) {
+    if (dimensions.x <= 0 or dimensions.y <= 0 or dimensions.x > 0x7FFF or dimensions.y > 0x7FFF) {
+        throw std::invalid_argument("Invalid frame export dimensions");
+    }
+    if (slots < 2) {
+        throw std::invalid_argument("Frame export needs at least two slots");
+    }
+    const auto size = static_cast<uint64_t>(slot_offset(dimensions, static_cast<size_t>(slots)));
+    mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), name.c_str());
+    if (mapping_ == nullptr) {
+        throw std::runtime_error("Failed to create shared memory '" + name + "'");
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping_);
+        throw std::runtime_error("Shared memory '" + name + "' is already in use");
+    }
+    view_ = static_cast<std::byte*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<size_t>(size)));
+    if (view_ == nullptr) {
+        CloseHandle(mapping_);
+        throw std::runtime_error("Failed to map shared memory '" + name + "'");
+    }
+
+    for (size_t slot = 0; slot < static_cast<size_t>(slots); ++slot) {
+        new (view_ + slot_offset(dimensions, slot)) Slot{ 0, 0, 0.0 };
+    }
+    Header& header = *new (view_) Header{ magic, 0, dimensions.x, dimensions.y, slots, sizeof(CHAR_INFO), 0 };
+    atomic(header.version).store(version, std::memory_order_release);
+}
+
+FrameExporter::~FrameExporter() {
+    UnmapViewOfFile(view_);
+    CloseHandle(mapping_);
+}
+
+const Coordinate<int>& FrameExporter::dimensions() const {
+    return dimensions_;
+}
+
+uint64_t FrameExporter::size() const {
+    return frames_;
+}
+
+void FrameExporter::publish(const double frame_time, const Surface& frame) {
+    if (frame.dimensions() != dimensions_) {
+        throw std::invalid_argument("Frame dimensions differ from the export's");
+    }
+    Header& header = *reinterpret_cast<Header*>(view_);
+    std::byte* const slot_data = view_ + slot_offset(dimensions_, static_cast<size_t>(frames_ % static_cast<uint64_t>(slots_)));
+    Slot& slot = *reinterpret_cast<Slot*>(slot_data);
+
+    const uint64_t sequence = atomic(slot.sequence).load(std::memory_order_relaxed);
+    atomic(slot.sequence).store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    atomic(slot.frame).store(frames_, std::memory_order_relaxed);
+    atomic(slot.frame_time).store(frame_time, std::memory_order_relaxed);
+    std::memcpy(slot_data + line, frame.data(), cells_size(dimensions_));
+    atomic(slot.sequence).store(sequence + 2, std::memory_order_release);
+
+    atomic(header.published).store(++frames_, std::memory_order_release);
+}
+
+
+FrameExportReader::FrameExportReader(const std::string& name) {
+    mapping_ = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (mapping_ == nullptr) {
+        throw std::runtime_error("No frame export named '" + name + "'");
+    }
+    view_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (view_ == nullptr) {
+        CloseHandle(mapping_);
+        throw std::runtime_error("Failed to map shared memory '" + name + "'");
+    }
+    // The view spans whole pages, so the header can be read before checking the frames it describes fit in the view.
+    // Dimensions are capped at the console's limit first so that the slots' extent cannot overflow.
+    MEMORY_BASIC_INFORMATION region = {};
+    const Header& header = *reinterpret_cast<const Header*>(view_);
+    if (VirtualQuery(view_, &region, sizeof region) == 0 or atomic(header.version).load(std::memory_order_acquire) != version or header.magic != magic
+        or header.cell_size != sizeof(CHAR_INFO) or header.width <= 0 or header.height <= 0 or header.width > 0x7FFF or header.height > 0x7FFF
+        or header.slots < 2 or slot_offset({ header.width, header.height }, static_cast<size_t>(header.slots)) > region.RegionSize) {
+        UnmapViewOfFile(view_);
+        CloseHandle(mapping_);
+        throw std::runtime_error("'" + name + "' is not a frame export");
+    }
+    dimensions_ = { header.width, header.height };
+    slots_ = header.slots;
+}
+
+FrameExportReader::~FrameExportReader() {
+    UnmapViewOfFile(view_);
+    CloseHandle(mapping_);
+}
+
+const Coordinate<int>& FrameExportReader::dimensions() const {
+    return dimensions_;
+}
+
+int FrameExportReader::slots() const {
+    return slots_;
+}
+
+uint64_t FrameExportReader::published() const {
+    return atomic(reinterpret_cast<const Header*>(view_)->published).load(std::memory_order_acquire);
+}
+
+uint64_t FrameExportReader::frame_number() const {
+    return frame_number_;
+}
+
+double FrameExportReader::frame_time() const {
+    return frame_time_;
+}
+
+uint64_t FrameExportReader::dropped() const {
+    return dropped_;
+}
+
+bool FrameExportReader::next(Surface& frame) {
+    while (true) {
+        const uint64_t published = this->published();
+        if (next_ >= published) {
+            return false;
+        }
+        if (published - next_ > static_cast<uint64_t>(slots_)) {
+            dropped_ += published - static_cast<uint64_t>(slots_) - next_;
+            next_ = published - static_cast<uint64_t>(slots_);
+        }
+        // Failing means the engine has lapped the reader and is overwriting the frame
+        if (read(next_++, frame)) {
+            return true;
+        }
+        ++dropped_;
+    }
+}
+
+bool FrameExportReader::latest(Surface& frame) {
+    for (int attempt = 0; attempt < slots_; ++attempt) {
+        const uint64_t published = this->published();
+        if (published == 0) {
+            return false;
+        }
+        if (read(published - 1, frame)) {
+            next_ = published;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Private
+
+
+bool FrameExportReader::read(const uint64_t frame, Surface& destination) {
+    if (destination.dimensions() != dimensions_) {
+        throw std::invalid_argument("Frame dimensions differ from the export's");
+    }
+    const std::byte* const slot_data = view_ + slot_offset(dimensions_, static_cast<size_t>(frame % static_cast<uint64_t>(slots_)));
+    const Slot& slot = *reinterpret_cast<const Slot*>(slot_data);
+
+    const uint64_t before = atomic(slot.sequence).load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    const uint64_t number = atomic(slot.frame).load(std::memory_order_relaxed);
+    const double frame_time = atomic(slot.frame_time).load(std::memory_order_relaxed);
+    std::memcpy(destination.data(), slot_data + line, cells_size(dimensions_));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (atomic(slot.sequence).load(std::memory_order_relaxed) != before or number != frame) {
+        return false;
+    }
+    frame_number_ = number;
+    frame_time_ = frame_time;
+    return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Surface.hpp"
+
+
+// Publishes presented frames into a named shared memory ring, for viewers and encoders running in other processes.
+// Every slot of the ring is guarded by a sequence number, odd while the slot is being written, so readers never take
+// a lock and the engine never waits for them or makes a system call once the mapping exists. A reader that falls
+// more than a ring behind loses the frames overwritten.
+class FrameExporter {
+public:
+
+    FrameExporter(const std::string& name, const Coordinate<int>& dimensions, int slots = 4);
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+    FrameExporter(FrameExporter&&) = delete;
+    FrameExporter& operator=(FrameExporter&&) = delete;
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    // Frames published so far
+    [[nodiscard]] uint64_t size() const;
+
+    void publish(double frame_time, const Surface&);
+
+private:
+
+    HANDLE mapping_ = nullptr;
+    std::byte* view_ = nullptr;
+    Coordinate<int> dimensions_;
+    // Kept here rather than read back from the header, which any process that opens the export can write to
+    int slots_;
+    uint64_t frames_ = 0;
+};
+
+
+// Reference reader of a FrameExporter's ring. Opens an existing export read only; frames are copied out of the ring
+// and checked against the slot's sequence number, so a frame torn by the engine overwriting it is never returned.
+//
+//     FrameExportReader reader("ConsoleGraphicsEngine");
+//     Surface frame(reader.dimensions());
+//     while (running) {
+//         if (reader.next(frame)) {
+//             encode(frame);
+//         }
+//     }
+class FrameExportReader {
+public:
+
+    explicit FrameExportReader(const std::string& name);
+    ~FrameExportReader();
+
+    FrameExportReader(const FrameExportReader&) = delete;
+    FrameExportReader& operator=(const FrameExportReader&) = delete;
+    FrameExportReader(FrameExportReader&&) = delete;
+    FrameExportReader& operator=(FrameExportReader&&) = delete;
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] int slots() const;
+    // Frames the engine has published
+    [[nodiscard]] uint64_t published() const;
+
+    // Number and frame time of the frame last read
+    [[nodiscard]] uint64_t frame_number() const;
+    [[nodiscard]] double frame_time() const;
+    // Frames overwritten before next() got to them
+    [[nodiscard]] uint64_t dropped() const;
+
+    // Copies the frame after the last one read, or the oldest still in the ring. Returns false if there is none yet.
+    bool next(Surface& frame);
+    // Copies the newest frame, for viewers that only show the present. Returns false if there is none yet.
+    bool latest(Surface& frame);
+
+private:
+
+    HANDLE mapping_ = nullptr;
+    const std::byte* view_ = nullptr;
+    Coordinate<int> dimensions_;
+    int slots_ = 0;
+    uint64_t next_ = 0, dropped_ = 0;
+    uint64_t frame_number_ = 0;
+    double frame_time_ = 0.0;
+
+    bool read(uint64_t frame, Surface&);
+};
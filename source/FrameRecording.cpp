@@ -0,0 +1,418 @@
+#include "pch.hpp"
+
+#include "FrameRecording.hpp"
+
+
+namespace {
+
+    constexpr std::array<char, 4> magic = { 'C', 'G', 'E', 'F' };
+    constexpr std::array<char, 4> index_magic = { 'C', 'G', 'E', 'X' };
+    constexpr uint8_t version = 1;
+
+    // Magic, version, width and height
+    constexpr size_t header_size = 4 + 1 + 2 + 2;
+    // Flags, frame time and payload size
+    constexpr size_t frame_header_size = 1 + 8 + 4;
+    // Keyframe count, frame count and magic
+    constexpr size_t footer_size = 8 + 8 + 4;
+
+    enum Flags : uint8_t {
+        Keyframed = 0x01,
+    };
+
+    // Payloads are runs, each a variable length count shifted left by two with the kind in the low bits
+    enum Run : uint8_t {
+        // Cells unchanged
+        Skip = 0,
+        // Cells all changed by the same value, stored once
+        Repeat = 1,
+        // Cells changed by the values stored
+        Literal = 2,
+    };
+
+    uint32_t pack(const CHAR_INFO& cell) {
+        return static_cast<uint32_t>(static_cast<uint16_t>(cell.Char.UnicodeChar)) | static_cast<uint32_t>(cell.Attributes) << 16;
+    }
+
+    CHAR_INFO unpack(const uint32_t cell) {
+        CHAR_INFO unpacked;
+        unpacked.Char.UnicodeChar = static_cast<WCHAR>(cell & 0xFFFF);
+        unpacked.Attributes = static_cast<WORD>(cell >> 16);
+        return unpacked;
+    }
+
+    template <typename type>
+    void write(std::vector<uint8_t>& buffer, const type value) {
+        std::array<uint8_t, sizeof(type)> bytes;
+        std::memcpy(bytes.data(), &value, sizeof(type));
+        if constexpr (std::endian::native == std::endian::big) {
+            std::reverse(bytes.begin(), bytes.end());
+        }
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    void write_count(std::vector<uint8_t>& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    // A full disk or removed drive would otherwise only show as a recording cut short when played
+    void flush(std::ofstream& stream, const std::vector<uint8_t>& buffer) {
+        if (not stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+            throw std::runtime_error("Failed to write frame recording");
+        }
+    }
+
+    template <typename type>
+    type read(const uint8_t* bytes) {
+        std::array<uint8_t, sizeof(type)> ordered;
+        std::copy_n(bytes, sizeof(type), ordered.begin());
+        if constexpr (std::endian::native == std::endian::big) {
+            std::reverse(ordered.begin(), ordered.end());
+        }
+        type value;
+        std::memcpy(&value, ordered.data(), sizeof(type));
+        return value;
+    }
+
+    template <typename type>
+    type read(std::istream& stream) {
+        std::array<uint8_t, sizeof(type)> bytes;
+        if (not stream.read(reinterpret_cast<char*>(bytes.data()), sizeof(type))) {
+            throw std::runtime_error("Truncated frame recording");
+        }
+        return read<type>(bytes.data());
+    }
+
+    uint64_t read_count(const std::vector<uint8_t>& buffer, size_t& offset) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (offset == buffer.size()) {
+                break;
+            }
+            const uint8_t byte = buffer[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (not (byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Corrupt frame recording");
+    }
+
+    // Length of the run of equal values starting at begin
+    size_t run(const std::vector<uint32_t>& values, const size_t begin) {
+        size_t end = begin + 1;
+        while (end < values.size() and values[end] == values[begin]) {
+            ++end;
+        }
+        return end - begin;
+    }
+}
+
+
+FrameRecorder::FrameRecorder(const std::string& file_name, const Coordinate<int>& dimensions, const int keyframe_interval)
+    : stream_(file_name, std::ios::out | std::ios::trunc | std::ios::binary), dimensions_(dimensions), keyframe_interval_(keyframe_interval) {
+    if (dimensions.x <= 0 or dimensions.y <= 0 or dimensions.x > 0x7FFF or dimensions.y > 0x7FFF) {
+        throw std::invalid_argument("Invalid frame recording dimensions");
+    }
+    if (keyframe_interval <= 0) {
+        throw std::invalid_argument("Keyframe interval must be positive");
+    }
+    if (not stream_.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    const size_t cells = static_cast<size_t>(dimensions.x) * dimensions.y;
+    previous_.resize(cells);
+    delta_.resize(cells);
+    // A frame where every cell changes to a different value is the worst case
+    buffer_.reserve(frame_header_size + 2 * sizeof(uint64_t) + cells * sizeof(uint32_t));
+
+    buffer_.insert(buffer_.end(), magic.begin(), magic.end());
+    write(buffer_, version);
+    write(buffer_, static_cast<int16_t>(dimensions.x));
+    write(buffer_, static_cast<int16_t>(dimensions.y));
+    flush(stream_, buffer_);
+}
+
+// Failures are swallowed here; close explicitly to hear of them
+FrameRecorder::~FrameRecorder() {
+    try {
+        close();
+    } catch (...) {}
+}
+
+const Coordinate<int>& FrameRecorder::dimensions() const {
+    return dimensions_;
+}
+
+size_t FrameRecorder::size() const {
+    return frames_;
+}
+
+void FrameRecorder::record(const double frame_time, const Surface& surface) {
+    if (surface.dimensions() != dimensions_) {
+        throw std::invalid_argument("Frame dimensions differ from the recording's");
+    }
+    if (not stream_.is_open()) {
+        throw std::runtime_error("Frame recording is closed");
+    }
+
+    const bool keyframe = frames_ % static_cast<size_t>(keyframe_interval_) == 0;
+    if (keyframe) {
+        keyframes_.push_back({ frames_, static_cast<uint64_t>(stream_.tellp()) });
+        std::fill(previous_.begin(), previous_.end(), 0);
+    }
+    const CHAR_INFO* cells = surface.data();
+    for (size_t cell = 0; cell < delta_.size(); ++cell) {
+        const uint32_t packed = pack(cells[cell]);
+        delta_[cell] = packed ^ previous_[cell];
+        previous_[cell] = packed;
+    }
+
+    buffer_.clear();
+    write(buffer_, static_cast<uint8_t>(keyframe ? Keyframed : 0));
+    write(buffer_, frame_time);
+    write(buffer_, static_cast<uint32_t>(0));
+
+    // Literal runs stop where at least two unchanged cells or three equal changes start
+    for (size_t cell = 0; cell < delta_.size();) {
+        const size_t same = run(delta_, cell);
+        if (delta_[cell] == 0 or same >= 3) {
+            write_count(buffer_, same << 2 | (delta_[cell] == 0 ? Skip : Repeat));
+            if (delta_[cell] != 0) {
+                write(buffer_, delta_[cell]);
+            }
+            cell += same;
+            continue;
+        }
+        size_t end = cell + same;
+        while (end < delta_.size()) {
+            const size_t next = run(delta_, end);
+            if (next >= (delta_[end] == 0 ? 2u : 3u)) {
+                break;
+            }
+            end += next;
+        }
+        write_count(buffer_, (end - cell) << 2 | Literal);
+        for (; cell < end; ++cell) {
+            write(buffer_, delta_[cell]);
+        }
+    }
+
+    const auto payload = static_cast<uint32_t>(buffer_.size() - frame_header_size);
+    std::array<uint8_t, sizeof(uint32_t)> size;
+    std::memcpy(size.data(), &payload, sizeof(uint32_t));
+    if constexpr (std::endian::native == std::endian::big) {
+        std::reverse(size.begin(), size.end());
+    }
+    std::copy(size.begin(), size.end(), buffer_.begin() + (frame_header_size - sizeof(uint32_t)));
+    flush(stream_, buffer_);
+    ++frames_;
+}
+
+void FrameRecorder::close() {
+    if (not stream_.is_open()) {
+        return;
+    }
+    buffer_.clear();
+    for (const auto& [frame, offset] : keyframes_) {
+        write(buffer_, frame);
+        write(buffer_, offset);
+    }
+    write(buffer_, static_cast<uint64_t>(keyframes_.size()));
+    write(buffer_, static_cast<uint64_t>(frames_));
+    buffer_.insert(buffer_.end(), index_magic.begin(), index_magic.end());
+    flush(stream_, buffer_);
+    stream_.close();
+    if (not stream_) {
+        throw std::runtime_error("Failed to write frame recording");
+    }
+}
+
+
+FramePlayer::FramePlayer(const std::string& file_name) : stream_(file_name, std::ios::in | std::ios::binary) {
+    if (not stream_.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    std::array<uint8_t, header_size> header;
+    if (not stream_.read(reinterpret_cast<char*>(header.data()), header.size()) or not std::equal(magic.begin(), magic.end(), header.begin()) or header[magic.size()] != version) {
+        throw std::runtime_error("'" + file_name + "' is not a frame recording");
+    }
+    const Coordinate<int> dimensions(read<int16_t>(header.data() + 5), read<int16_t>(header.data() + 7));
+    if (dimensions.x <= 0 or dimensions.y <= 0) {
+        throw std::runtime_error("'" + file_name + "' is not a frame recording");
+    }
+    frame_ = Surface(dimensions);
+    cells_.resize(static_cast<size_t>(dimensions.x) * dimensions.y);
+
+    stream_.seekg(0, std::ios::end);
+    const auto file_size = static_cast<uint64_t>(stream_.tellg());
+    std::array<uint8_t, footer_size> footer = {};
+    if (file_size >= header_size + footer_size) {
+        stream_.seekg(static_cast<std::streamoff>(file_size - footer_size));
+        stream_.read(reinterpret_cast<char*>(footer.data()), footer.size());
+    }
+    const uint64_t keyframes = read<uint64_t>(footer.data());
+    if (not std::equal(index_magic.begin(), index_magic.end(), footer.begin() + 16) or keyframes > (file_size - header_size - footer_size) / 16) {
+        // Never closed: find the frames that were written whole
+        stream_.clear();
+        scan(file_size);
+    } else {
+        frames_ = read<uint64_t>(footer.data() + 8);
+        stream_.seekg(static_cast<std::streamoff>(file_size - footer_size - keyframes * 16));
+        keyframes_.resize(keyframes);
+        for (auto& [frame, offset] : keyframes_) {
+            frame = read<uint64_t>(stream_);
+            offset = read<uint64_t>(stream_);
+        }
+    }
+    if (frames_ > 0 and (keyframes_.empty() or keyframes_.front().frame != 0)) {
+        throw std::runtime_error("'" + file_name + "' has no keyframe index");
+    }
+    stream_.seekg(static_cast<std::streamoff>(header_size));
+}
+
+const Coordinate<int>& FramePlayer::dimensions() const {
+    return frame_.dimensions();
+}
+
+size_t FramePlayer::size() const {
+    return frames_;
+}
+
+size_t FramePlayer::position() const {
+    return position_;
+}
+
+bool FramePlayer::finished() const {
+    return position_ == frames_;
+}
+
+const Surface& FramePlayer::frame() const {
+    return frame_;
+}
+
+double FramePlayer::frame_time() const {
+    return frame_time_;
+}
+
+bool FramePlayer::next() {
+    if (finished()) {
+        return false;
+    }
+    decode();
+    return true;
+}
+
+void FramePlayer::seek(const size_t frame) {
+    if (frame >= frames_) {
+        throw std::out_of_range("Frame " + std::to_string(frame) + " is past the end of the recording");
+    }
+    const Keyframe& keyframe = *std::prev(std::upper_bound(keyframes_.begin(), keyframes_.end(), frame, [](const size_t frame, const Keyframe& keyframe) {
+        return frame < keyframe.frame;
+    }));
+    // Decoding on from the current frame is cheaper unless a keyframe lies between
+    if (position_ == 0 or frame + 1 < position_ or keyframe.frame >= position_) {
+        stream_.clear();
+        stream_.seekg(static_cast<std::streamoff>(keyframe.offset));
+        position_ = static_cast<size_t>(keyframe.frame);
+    }
+    while (position_ <= frame) {
+        decode();
+    }
+    owed_ = 0.0;
+}
+
+bool FramePlayer::advance(const double seconds) {
+    owed_ += seconds * speed_;
+    while (owed_ > 0.0 and next()) {
+        owed_ -= frame_time_;
+    }
+    if (finished()) {
+        owed_ = 0.0;
+    }
+    return not finished();
+}
+
+void FramePlayer::set_speed(const double speed) {
+    if (speed <= 0.0) {
+        throw std::invalid_argument("Playback speed must be positive");
+    }
+    speed_ = speed;
+}
+
+double FramePlayer::speed() const {
+    return speed_;
+}
+
+
+// Private
+
+
+void FramePlayer::scan(const uint64_t data_end) {
+    keyframes_.clear();
+    frames_ = 0;
+    uint64_t offset = header_size;
+    std::array<uint8_t, frame_header_size> header;
+    while (offset + frame_header_size <= data_end) {
+        stream_.seekg(static_cast<std::streamoff>(offset));
+        if (not stream_.read(reinterpret_cast<char*>(header.data()), header.size())) {
+            break;
+        }
+        const uint64_t end = offset + frame_header_size + read<uint32_t>(header.data() + 9);
+        if (end > data_end) {
+            break;
+        }
+        if (header[0] & Keyframed) {
+            keyframes_.push_back({ frames_, offset });
+        }
+        ++frames_;
+        offset = end;
+    }
+    stream_.clear();
+}
+
+void FramePlayer::decode() {
+    const auto flags = read<uint8_t>(stream_);
+    frame_time_ = read<double>(stream_);
+    buffer_.resize(read<uint32_t>(stream_));
+    if (not stream_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()))) {
+        throw std::runtime_error("Truncated frame recording");
+    }
+
+    if (flags & Keyframed) {
+        std::fill(cells_.begin(), cells_.end(), 0);
+    }
+    size_t offset = 0, cell = 0;
+    while (offset < buffer_.size()) {
+        const uint64_t token = read_count(buffer_, offset);
+        const uint64_t count = token >> 2;
+        const auto kind = static_cast<Run>(token & 0x03);
+        const size_t values = kind == Literal ? count : kind == Repeat ? 1 : 0;
+        if (count > cells_.size() - cell or kind > Literal or offset + values * sizeof(uint32_t) > buffer_.size()) {
+            throw std::runtime_error("Corrupt frame recording");
+        }
+        if (kind == Repeat) {
+            const auto value = read<uint32_t>(buffer_.data() + offset);
+            offset += sizeof(uint32_t);
+            for (const size_t end = cell + count; cell < end; ++cell) {
+                cells_[cell] ^= value;
+            }
+        } else if (kind == Literal) {
+            for (const size_t end = cell + count; cell < end; ++cell, offset += sizeof(uint32_t)) {
+                cells_[cell] ^= read<uint32_t>(buffer_.data() + offset);
+            }
+        } else {
+            cell += count;
+        }
+    }
+
+    CHAR_INFO* cells = frame_.data();
+    for (size_t index = 0; index < cells_.size(); ++index) {
+        cells[index] = unpack(cells_[index]);
+    }
+    ++position_;
+}
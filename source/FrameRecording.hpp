@@ -0,0 +1,99 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Surface.hpp"
+
+
+// Streams frames to a file as they are presented. Every frame is stored as its exclusive or with the frame before,
+// run length encoded, so cells that did not change cost next to nothing. Every keyframe_interval frames, one is stored
+// against a blank frame instead so playback can seek to it; the offsets of these keyframes are written as an index
+// when the recorder closes. A recording cut short by a crash still plays, the index is then rebuilt by scanning it.
+class FrameRecorder {
+public:
+
+    FrameRecorder(const std::string& filename, const Coordinate<int>& dimensions, int keyframe_interval = 600);
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+    FrameRecorder(FrameRecorder&&) = delete;
+    FrameRecorder& operator=(FrameRecorder&&) = delete;
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] size_t size() const;
+
+    void record(double frame_time, const Surface&);
+
+    // Writes the index; no frames can be recorded after. Recording and closing throw when the file cannot be written.
+    void close();
+
+private:
+
+    struct Keyframe {
+        uint64_t frame, offset;
+    };
+
+    std::ofstream stream_;
+    Coordinate<int> dimensions_;
+    int keyframe_interval_;
+    // Cells packed as the glyph in the low half and the attributes in the high half
+    std::vector<uint32_t> previous_, delta_;
+    std::vector<uint8_t> buffer_;
+    std::vector<Keyframe> keyframes_;
+    size_t frames_ = 0;
+};
+
+
+// Plays back a recording made by FrameRecorder, decoding frames on demand from the file. Decoding touches each cell
+// once, so it runs far faster than the recording's own pace; seeking decodes from the nearest keyframe before.
+class FramePlayer {
+public:
+
+    explicit FramePlayer(const std::string& filename);
+
+    FramePlayer(const FramePlayer&) = delete;
+    FramePlayer& operator=(const FramePlayer&) = delete;
+    FramePlayer(FramePlayer&&) = delete;
+    FramePlayer& operator=(FramePlayer&&) = delete;
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] size_t size() const;
+    // Frames decoded so far; the current frame is the one before
+    [[nodiscard]] size_t position() const;
+    [[nodiscard]] bool finished() const;
+
+    // Blank until the first frame has been decoded
+    [[nodiscard]] const Surface& frame() const;
+    // Time the current frame was shown for when it was recorded
+    [[nodiscard]] double frame_time() const;
+
+    // Decodes the next frame, returning false once the recording has run out
+    bool next();
+    // Makes frame the current frame
+    void seek(size_t frame);
+
+    // Plays seconds of the recording at its recorded pace times speed, decoding every frame they cover. Returns false
+    // once the recording has run out.
+    bool advance(double seconds);
+    void set_speed(double speed);
+    [[nodiscard]] double speed() const;
+
+private:
+
+    struct Keyframe {
+        uint64_t frame, offset;
+    };
+
+    std::ifstream stream_;
+    Surface frame_;
+    std::vector<uint32_t> cells_;
+    std::vector<uint8_t> buffer_;
+    std::vector<Keyframe> keyframes_;
+    size_t frames_ = 0, position_ = 0;
+    double frame_time_ = 0.0, speed_ = 1.0, owed_ = 0.0;
+
+    void scan(uint64_t data_end);
+    void decode();
+};
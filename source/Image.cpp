@@ -0,0 +1,363 @@
+#include "pch.hpp"
+
+#include "Image.hpp"
+
+using enum Pixel::Shade;
+
+
+namespace {
+
+    // Legacy console palette, in the order of Pixel::Colour
+    constexpr std::array<Image::Rgb, 16> palette = { {
+        { 0, 0, 0 },
+        { 0, 0, 128 },
+        { 0, 128, 0 },
+        { 0, 128, 128 },
+        { 128, 0, 0 },
+        { 128, 0, 128 },
+        { 128, 128, 0 },
+        { 192, 192, 192 },
+        { 128, 128, 128 },
+        { 0, 0, 255 },
+        { 0, 255, 0 },
+        { 0, 255, 255 },
+        { 255, 0, 0 },
+        { 255, 0, 255 },
+        { 255, 255, 0 },
+        { 255, 255, 255 },
+    } };
+
+    struct Candidate {
+        float red, green, blue;
+        Pixel pixel;
+    };
+
+    // Every solid colour, and every pair of colours blended by the three partial shades
+    std::vector<Candidate> make_candidates() {
+        constexpr std::array<std::pair<Pixel::Shade, float>, 3> shades = { { { Quarter, 0.25f }, { Half, 0.5f }, { ThreeQuarters, 0.75f } } };
+        std::vector<Candidate> candidates;
+        for (WORD colour = 0; colour < 16; ++colour) {
+            candidates.push_back({ static_cast<float>(palette[colour].red), static_cast<float>(palette[colour].green), static_cast<float>(palette[colour].blue), Pixel(static_cast<Pixel::Colour>(colour)) });
+        }
+        for (WORD foreground = 0; foreground < 16; ++foreground) {
+            for (WORD background_colour = 0; background_colour < 16; ++background_colour) {
+                if (foreground == background_colour) {
+                    continue;
+                }
+                const Image::Rgb& front = palette[foreground];
+                const Image::Rgb& back = palette[background_colour];
+                for (const auto& [shade, coverage] : shades) {
+                    candidates.push_back({
+                        front.red * coverage + back.red * (1.0f - coverage),
+                        front.green * coverage + back.green * (1.0f - coverage),
+                        front.blue * coverage + back.blue * (1.0f - coverage),
+                        Pixel(static_cast<Pixel::Colour>(foreground), static_cast<Pixel::Colour>(background_colour), shade),
+                    });
+                }
+            }
+        }
+        return candidates;
+    }
+
+    // Skips whitespace and comments, then reads a decimal value and the single character after it
+    int read_value(std::istream& stream) {
+        int character = stream.get();
+        while (std::isspace(character) or character == '#') {
+            if (character == '#') {
+                while (character != '\n' and character != EOF) {
+                    character = stream.get();
+                }
+            }
+            character = stream.get();
+        }
+        if (not std::isdigit(character)) {
+            throw std::runtime_error("Malformed image file");
+        }
+        int value = 0;
+        while (std::isdigit(character)) {
+            if (value > (INT32_MAX - (character - '0')) / 10) {
+                throw std::runtime_error("Malformed image file");
+            }
+            value = value * 10 + (character - '0');
+            character = stream.get();
+        }
+        return value;
+    }
+
+    // Bounds what a corrupt header can make the decoders allocate
+    constexpr size_t maximum_pixels = size_t(1) << 26;
+
+    bool valid_dimensions(const int width, const int height) {
+        return width > 0 and height > 0 and static_cast<size_t>(width) * height <= maximum_pixels;
+    }
+
+    uint32_t little_endian(const std::vector<uint8_t>& bytes, const size_t offset, const int size) {
+        if (offset + size > bytes.size()) {
+            throw std::runtime_error("Truncated bitmap file");
+        }
+        uint32_t value = 0;
+        for (int index = size - 1; index >= 0; --index) {
+            value = (value << 8) | bytes[offset + index];
+        }
+        return value;
+    }
+
+    uint8_t masked(const uint32_t value, const uint32_t mask) {
+        if (mask == 0) {
+            return 0;
+        }
+        // In 64 bits, as a full 32 bit mask times 255 would overflow
+        const uint64_t maximum = mask >> std::countr_zero(mask);
+        return static_cast<uint8_t>(static_cast<uint64_t>((value & mask) >> std::countr_zero(mask)) * 255 / maximum);
+    }
+}
+
+
+Image::Image() : dimensions_(0, 0) {}
+
+Image::Image(const Coordinate<int>& dimensions) : dimensions_(dimensions) {
+    if (dimensions.x < 0 or dimensions.y < 0) {
+        throw std::invalid_argument("Image dimensions must not be negative");
+    }
+    pixels_.assign(static_cast<size_t>(dimensions.x) * dimensions.y, Rgb{ 0, 0, 0 });
+}
+
+Image::Image(const std::string& filename) {
+    load(filename);
+}
+
+
+const Coordinate<int>& Image::dimensions() const {
+    return dimensions_;
+}
+
+int Image::width() const {
+    return dimensions_.x;
+}
+
+int Image::height() const {
+    return dimensions_.y;
+}
+
+Image::Rgb* Image::row(const int y) {
+    return pixels_.data() + static_cast<size_t>(y) * dimensions_.x;
+}
+
+const Image::Rgb* Image::row(const int y) const {
+    return pixels_.data() + static_cast<size_t>(y) * dimensions_.x;
+}
+
+
+void Image::load(const std::string& file_name) {
+    std::ifstream file_stream(file_name, std::ios::in | std::ios::binary);
+    if (not file_stream.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    std::array<char, 2> magic = {};
+    file_stream.read(magic.data(), magic.size());
+    if (magic[0] == 'P' and (magic[1] == '2' or magic[1] == '3' or magic[1] == '5' or magic[1] == '6')) {
+        read_netpbm(file_stream, magic[1]);
+    } else if (magic[0] == 'B' and magic[1] == 'M') {
+        file_stream.seekg(0);
+        read_bmp(file_stream);
+    } else {
+        throw std::runtime_error("Unsupported image format in '" + file_name + "'");
+    }
+}
+
+
+Image Image::resample(const Coordinate<int>& dimensions, const Filter filter, JobSystem& jobs) const {
+    if (dimensions_.x <= 0 or dimensions_.y <= 0) {
+        throw std::invalid_argument("Cannot resample an empty image");
+    }
+    Image result(dimensions);
+    jobs.parallel_for(0, dimensions.y, [&](const int first, const int last) {
+        for (int y = first; y < last; ++y) {
+            Rgb* destination = result.row(y);
+            if (filter == Filter::Box) {
+                const int top = static_cast<int>(static_cast<int64_t>(y) * dimensions_.y / dimensions.y);
+                const int bottom_limit = static_cast<int>(static_cast<int64_t>(y + 1) * dimensions_.y / dimensions.y);
+                const int bottom = bottom_limit > top ? bottom_limit : top + 1;
+                for (int x = 0; x < dimensions.x; ++x) {
+                    const int left = static_cast<int>(static_cast<int64_t>(x) * dimensions_.x / dimensions.x);
+                    const int right_limit = static_cast<int>(static_cast<int64_t>(x + 1) * dimensions_.x / dimensions.x);
+                    const int right = right_limit > left ? right_limit : left + 1;
+                    uint32_t red = 0, green = 0, blue = 0;
+                    for (int source_y = top; source_y < bottom; ++source_y) {
+                        const Rgb* source = row(source_y);
+                        for (int source_x = left; source_x < right; ++source_x) {
+                            red += source[source_x].red;
+                            green += source[source_x].green;
+                            blue += source[source_x].blue;
+                        }
+                    }
+                    const uint32_t count = static_cast<uint32_t>((bottom - top) * (right - left));
+                    destination[x] = { static_cast<uint8_t>((red + count / 2) / count), static_cast<uint8_t>((green + count / 2) / count), static_cast<uint8_t>((blue + count / 2) / count) };
+                }
+            } else {
+                const float source_y = (static_cast<float>(y) + 0.5f) * static_cast<float>(dimensions_.y) / static_cast<float>(dimensions.y) - 0.5f;
+                const int top = source_y > 0.0f ? static_cast<int>(source_y) : 0;
+                const int bottom = top + 1 < dimensions_.y ? top + 1 : top;
+                const float fraction_y = source_y > 0.0f ? source_y - static_cast<float>(top) : 0.0f;
+                const Rgb* upper = row(top);
+                const Rgb* lower = row(bottom);
+                for (int x = 0; x < dimensions.x; ++x) {
+                    const float source_x = (static_cast<float>(x) + 0.5f) * static_cast<float>(dimensions_.x) / static_cast<float>(dimensions.x) - 0.5f;
+                    const int left = source_x > 0.0f ? static_cast<int>(source_x) : 0;
+                    const int right = left + 1 < dimensions_.x ? left + 1 : left;
+                    const float fraction_x = source_x > 0.0f ? source_x - static_cast<float>(left) : 0.0f;
+                    const auto blend = [&](const uint8_t Rgb::* channel) {
+                        const float top_value = static_cast<float>(upper[left].*channel) * (1.0f - fraction_x) + static_cast<float>(upper[right].*channel) * fraction_x;
+                        const float bottom_value = static_cast<float>(lower[left].*channel) * (1.0f - fraction_x) + static_cast<float>(lower[right].*channel) * fraction_x;
+                        return static_cast<uint8_t>(top_value * (1.0f - fraction_y) + bottom_value * fraction_y + 0.5f);
+                    };
+                    destination[x] = { blend(&Rgb::red), blend(&Rgb::green), blend(&Rgb::blue) };
+                }
+            }
+        }
+    }, 4);
+    return result;
+}
+
+
+Sprite Image::to_sprite(JobSystem& jobs) const {
+    Sprite sprite(dimensions_);
+    jobs.parallel_for(0, dimensions_.y, [&](const int first, const int last) {
+        for (int y = first; y < last; ++y) {
+            const Rgb* source = row(y);
+            CHAR_INFO* destination = sprite.row(y);
+            for (int x = 0; x < dimensions_.x; ++x) {
+                destination[x] = quantize(source[x]).char_info();
+            }
+        }
+    }, 4);
+    return sprite;
+}
+
+Sprite Image::to_sprite(const Coordinate<int>& dimensions, const Filter filter, JobSystem& jobs) const {
+    if (dimensions == dimensions_) {
+        return to_sprite(jobs);
+    }
+    return resample(dimensions, filter, jobs).to_sprite(jobs);
+}
+
+
+Pixel Image::quantize(const Rgb& colour) {
+    static const std::vector<Candidate> candidates = make_candidates();
+    // Closest candidate per 5 bit colour, plus one so that zero means not yet searched
+    static std::array<std::atomic<uint16_t>, 1 << 15> nearest = {};
+
+    const size_t key = static_cast<size_t>(colour.red >> 3) << 10 | static_cast<size_t>(colour.green >> 3) << 5 | static_cast<size_t>(colour.blue >> 3);
+    uint16_t found = nearest[key].load(std::memory_order_relaxed);
+    if (found == 0) {
+        const float red = static_cast<float>((colour.red & 0xF8) | 4), green = static_cast<float>((colour.green & 0xF8) | 4), blue = static_cast<float>((colour.blue & 0xF8) | 4);
+        float best = std::numeric_limits<float>::infinity();
+        for (size_t index = 0; index < candidates.size(); ++index) {
+            const float delta_red = candidates[index].red - red, delta_green = candidates[index].green - green, delta_blue = candidates[index].blue - blue;
+            // Weighted towards green, which the eye is most sensitive to
+            const float distance = 3.0f * delta_red * delta_red + 4.0f * delta_green * delta_green + 2.0f * delta_blue * delta_blue;
+            if (distance < best) {
+                best = distance;
+                found = static_cast<uint16_t>(index + 1);
+            }
+        }
+        nearest[key].store(found, std::memory_order_relaxed);
+    }
+    return candidates[found - 1].pixel;
+}
+
+
+// Private
+
+
+void Image::read_netpbm(std::istream& stream, const char format) {
+    const bool colour = format == '3' or format == '6';
+    const bool binary = format == '5' or format == '6';
+    const int width = read_value(stream);
+    const int height = read_value(stream);
+    const int maximum = read_value(stream);
+    if (not valid_dimensions(width, height) or maximum <= 0 or maximum > 65535) {
+        throw std::runtime_error("Malformed image header");
+    }
+    *this = Image(Coordinate<int>(width, height));
+
+    const int channels = colour ? 3 : 1;
+    const size_t samples = pixels_.size() * channels;
+    std::vector<uint16_t> values(samples);
+    if (binary) {
+        const size_t sample_size = maximum < 256 ? 1 : 2;
+        std::vector<uint8_t> bytes(samples * sample_size);
+        if (not stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+            throw std::runtime_error("Truncated image file");
+        }
+        for (size_t index = 0; index < samples; ++index) {
+            values[index] = sample_size == 1 ? bytes[index] : static_cast<uint16_t>(bytes[index * 2] << 8 | bytes[index * 2 + 1]);
+        }
+    } else {
+        for (uint16_t& value : values) {
+            value = static_cast<uint16_t>(read_value(stream));
+        }
+    }
+
+    const auto scale = [maximum](const uint32_t value) { return static_cast<uint8_t>(((value > static_cast<uint32_t>(maximum) ? maximum : value) * 255 + maximum / 2) / maximum); };
+    for (size_t index = 0; index < pixels_.size(); ++index) {
+        const uint16_t* sample = values.data() + index * channels;
+        pixels_[index] = colour ? Rgb{ scale(sample[0]), scale(sample[1]), scale(sample[2]) } : Rgb{ scale(sample[0]), scale(sample[0]), scale(sample[0]) };
+    }
+}
+
+void Image::read_bmp(std::istream& stream) {
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    const uint32_t data_offset = little_endian(bytes, 10, 4);
+    const uint32_t header_size = little_endian(bytes, 14, 4);
+    const int width = static_cast<int32_t>(little_endian(bytes, 18, 4));
+    const int signed_height = static_cast<int32_t>(little_endian(bytes, 22, 4));
+    const uint32_t bits = little_endian(bytes, 28, 2);
+    const uint32_t compression = little_endian(bytes, 30, 4);
+    const bool bitfields = compression == 3 and bits == 32;
+    if (header_size < 40 or (compression != 0 and not bitfields) or (bits != 8 and bits != 24 and bits != 32)) {
+        throw std::runtime_error("Unsupported bitmap format");
+    }
+    if (signed_height == INT32_MIN) {
+        throw std::runtime_error("Malformed bitmap header");
+    }
+    const int height = signed_height < 0 ? -signed_height : signed_height;
+    if (not valid_dimensions(width, height)) {
+        throw std::runtime_error("Malformed bitmap header");
+    }
+
+    std::array<Rgb, 256> colours = {};
+    if (bits == 8) {
+        const uint32_t used = little_endian(bytes, 46, 4);
+        const uint32_t count = used == 0 or used > 256 ? 256 : used;
+        for (uint32_t index = 0; index < count; ++index) {
+            const size_t entry = 14 + header_size + index * 4;
+            colours[index] = { static_cast<uint8_t>(little_endian(bytes, entry + 2, 1)), static_cast<uint8_t>(little_endian(bytes, entry + 1, 1)), static_cast<uint8_t>(little_endian(bytes, entry, 1)) };
+        }
+    }
+    // Masks follow a 40 byte header and are the first fields of longer ones, so are at the same offset either way
+    const uint32_t red_mask = bitfields ? little_endian(bytes, 54, 4) : 0x00FF0000;
+    const uint32_t green_mask = bitfields ? little_endian(bytes, 58, 4) : 0x0000FF00;
+    const uint32_t blue_mask = bitfields ? little_endian(bytes, 62, 4) : 0x000000FF;
+
+    const size_t stride = (static_cast<size_t>(width) * bits + 31) / 32 * 4;
+    if (data_offset + stride * height > bytes.size()) {
+        throw std::runtime_error("Truncated bitmap file");
+    }
+    *this = Image(Coordinate<int>(width, height));
+    for (int y = 0; y < height; ++y) {
+        // Rows are stored bottom up unless the height is negative
+        const uint8_t* source = bytes.data() + data_offset + stride * (signed_height < 0 ? y : height - 1 - y);
+        Rgb* destination = row(y);
+        for (int x = 0; x < width; ++x) {
+            if (bits == 8) {
+                destination[x] = colours[source[x]];
+            } else if (bits == 24) {
+                destination[x] = { source[x * 3 + 2], source[x * 3 + 1], source[x * 3] };
+            } else {
+                const uint32_t value = static_cast<uint32_t>(source[x * 4]) | static_cast<uint32_t>(source[x * 4 + 1]) << 8 | static_cast<uint32_t>(source[x * 4 + 2]) << 16 | static_cast<uint32_t>(source[x * 4 + 3]) << 24;
+                destination[x] = { masked(value, red_mask), masked(value, green_mask), masked(value, blue_mask) };
+            }
+        }
+    }
+}
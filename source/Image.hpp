@@ -0,0 +1,55 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Pixel.hpp"
+#include "Sprite.hpp"
+#include "JobSystem.hpp"
+
+
+// RGB image decoded from an uncompressed file: binary or plain PPM and PGM, and 8, 24 or 32 bit BMP. Converts to a
+// sprite by resampling to the cell dimensions wanted and quantizing every pixel to the console cell closest in colour.
+class Image {
+public:
+
+    struct Rgb {
+        uint8_t red, green, blue;
+    };
+
+    enum class Filter {
+        Box,
+        Bilinear,
+    };
+
+    Image();
+    explicit Image(const Coordinate<int>& dimensions);
+    explicit Image(const std::string& filename);
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] int width() const;
+    [[nodiscard]] int height() const;
+
+    [[nodiscard]] Rgb* row(int y);
+    [[nodiscard]] const Rgb* row(int y) const;
+
+    // Files whose headers are malformed or describe more than 2^26 pixels are rejected
+    void load(const std::string& filename);
+
+    [[nodiscard]] Image resample(const Coordinate<int>& dimensions, Filter, JobSystem&) const;
+
+    // One cell per pixel
+    [[nodiscard]] Sprite to_sprite(JobSystem&) const;
+    [[nodiscard]] Sprite to_sprite(const Coordinate<int>& dimensions, Filter, JobSystem&) const;
+
+    // Foreground, background and shade whose blend is closest to the colour
+    [[nodiscard]] static Pixel quantize(const Rgb&);
+
+private:
+
+    Coordinate<int> dimensions_;
+    std::vector<Rgb> pixels_;
+
+    void read_netpbm(std::istream&, char format);
+    void read_bmp(std::istream&);
+};
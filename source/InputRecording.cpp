@@ -0,0 +1,139 @@
+#include "pch.hpp"
+
+#include "InputRecording.hpp"
+
+
+namespace {
+
+    constexpr std::array<char, 4> magic = { 'C', 'G', 'E', 'I' };
+    constexpr uint8_t version = 1;
+
+    enum Flags : uint8_t {
+        MouseMoved = 0x01,
+    };
+
+    template <typename type>
+    void write(std::vector<uint8_t>& buffer, const type value) {
+        std::array<uint8_t, sizeof(type)> bytes;
+        std::memcpy(bytes.data(), &value, sizeof(type));
+        if constexpr (std::endian::native == std::endian::big) {
+            std::reverse(bytes.begin(), bytes.end());
+        }
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    void flush(std::ofstream& stream, const char* const data, const size_t size) {
+        if (not stream.write(data, static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Failed to write input recording");
+        }
+    }
+
+    template <typename type>
+    bool read(const std::vector<uint8_t>& buffer, size_t& offset, type& value) {
+        if (offset + sizeof(type) > buffer.size()) {
+            return false;
+        }
+        std::array<uint8_t, sizeof(type)> bytes;
+        std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), sizeof(type), bytes.begin());
+        if constexpr (std::endian::native == std::endian::big) {
+            std::reverse(bytes.begin(), bytes.end());
+        }
+        offset += sizeof(type);
+        std::memcpy(&value, bytes.data(), sizeof(type));
+        return true;
+    }
+
+    // Applies one frame's changes to input, returning false, with input unchanged, if the frame is cut short
+    bool read_frame(const std::vector<uint8_t>& buffer, size_t& offset, double& frame_time, InputState& input) {
+        InputState next = input;
+        uint8_t flags;
+        uint16_t changes;
+        if (not read(buffer, offset, frame_time) or not read(buffer, offset, flags) or not read(buffer, offset, changes)) {
+            return false;
+        }
+        for (uint16_t change = 0; change < changes; ++change) {
+            uint8_t key;
+            if (not read(buffer, offset, key)) {
+                return false;
+            }
+            next.down.flip(key);
+        }
+        if (flags & MouseMoved) {
+            int16_t x, y;
+            if (not read(buffer, offset, x) or not read(buffer, offset, y)) {
+                return false;
+            }
+            next.mouse = { x, y };
+        }
+        input = next;
+        return true;
+    }
+}
+
+
+InputRecorder::InputRecorder(const std::string& file_name) : stream_(file_name, std::ios::out | std::ios::trunc | std::ios::binary) {
+    if (not stream_.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    flush(stream_, magic.data(), magic.size());
+    flush(stream_, reinterpret_cast<const char*>(&version), sizeof(version));
+    buffer_.reserve(4 + sizeof(double) + 256 + 2 * sizeof(int16_t));
+}
+
+void InputRecorder::record(const double frame_time, const InputState& input) {
+    buffer_.clear();
+    write(buffer_, frame_time);
+    const std::bitset<256> changed = input.down ^ previous_.down;
+    const bool mouse_moved = input.mouse != previous_.mouse;
+    write(buffer_, static_cast<uint8_t>(mouse_moved ? MouseMoved : 0));
+    write(buffer_, static_cast<uint16_t>(changed.count()));
+    for (size_t key = 0; key < changed.size(); ++key) {
+        if (changed[key]) {
+            write(buffer_, static_cast<uint8_t>(key));
+        }
+    }
+    if (mouse_moved) {
+        write(buffer_, static_cast<int16_t>(input.mouse.x));
+        write(buffer_, static_cast<int16_t>(input.mouse.y));
+    }
+    flush(stream_, reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+    previous_ = input;
+}
+
+
+InputReplay::InputReplay(const std::string& file_name) {
+    std::ifstream file_stream(file_name, std::ios::in | std::ios::binary);
+    if (not file_stream.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+    if (bytes.size() < magic.size() + 1 or not std::equal(magic.begin(), magic.end(), bytes.begin()) or bytes[magic.size()] != version) {
+        throw std::runtime_error("'" + file_name + "' is not an input recording");
+    }
+
+    // A recording cut short mid-frame, by a crash or a full disk, plays up to its last complete frame
+    size_t offset = magic.size() + 1;
+    InputState input;
+    double frame_time;
+    while (offset < bytes.size() and read_frame(bytes, offset, frame_time, input)) {
+        frames_.push_back({ frame_time, input });
+    }
+}
+
+size_t InputReplay::size() const {
+    return frames_.size();
+}
+
+bool InputReplay::finished() const {
+    return next_ == frames_.size();
+}
+
+bool InputReplay::next(double& frame_time, InputState& input) {
+    if (finished()) {
+        return false;
+    }
+    frame_time = frames_[next_].frame_time;
+    input = frames_[next_].input;
+    ++next_;
+    return true;
+}
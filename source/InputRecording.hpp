@@ -0,0 +1,54 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+
+
+// Input as sampled once at the start of a frame: which virtual keys and mouse buttons are down, and the mouse cell
+struct InputState {
+    std::bitset<256> down;
+    Coordinate<int> mouse;
+};
+
+
+// Writes the frame time and input of every frame to a compact binary file: per frame, the frame time, then only the
+// keys that changed and the mouse position if it moved.
+class InputRecorder {
+public:
+
+    explicit InputRecorder(const std::string& filename);
+
+    // Throws when the file cannot be written
+    void record(double frame_time, const InputState&);
+
+private:
+
+    std::ofstream stream_;
+    InputState previous_;
+    std::vector<uint8_t> buffer_;
+};
+
+
+// Reads a whole recording up front, so that playing it back does no I/O. A final frame cut short is dropped.
+class InputReplay {
+public:
+
+    explicit InputReplay(const std::string& filename);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool finished() const;
+
+    // Advances to the next frame, returning false once the recording has run out
+    bool next(double& frame_time, InputState&);
+
+private:
+
+    struct Frame {
+        double frame_time;
+        InputState input;
+    };
+
+    std::vector<Frame> frames_;
+    size_t next_ = 0;
+};
@@ -0,0 +1,177 @@
+#include "pch.hpp"
+
+#include "JobSystem.hpp"
+
+
+bool JobSystem::Counter::done() const {
+    return count_.load(std::memory_order_acquire) == 0;
+}
+
+
+JobSystem::Graph::Task JobSystem::Graph::add(std::function<void()> function) {
+    nodes_.emplace_back().function = std::move(function);
+    return nodes_.size() - 1;
+}
+
+void JobSystem::Graph::precede(const Task before, const Task after) {
+    if (before >= after or after >= nodes_.size()) {
+        throw std::invalid_argument("Tasks can only depend on tasks added before them");
+    }
+    nodes_[before].successors.push_back(after);
+    ++nodes_[after].dependencies;
+}
+
+size_t JobSystem::Graph::size() const {
+    return nodes_.size();
+}
+
+
+JobSystem::JobSystem() : JobSystem(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0) {}
+
+JobSystem::JobSystem(const size_t workers) {
+    for (size_t index = 0; index <= workers; ++index) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t index = 1; index <= workers; ++index) {
+        workers_.emplace_back(&JobSystem::work, this, index);
+    }
+}
+
+JobSystem::~JobSystem() {
+    stopping_ = true;
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t JobSystem::threads() const {
+    return workers_.size() + 1;
+}
+
+
+void JobSystem::wait(Counter& counter) {
+    const size_t own = queue();
+    while (not counter.done()) {
+        if (not try_run(own)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::run(Graph& graph) {
+    Counter counter;
+    graph.system_ = this;
+    graph.counter_ = &counter;
+    for (Graph::Node& node : graph.nodes_) {
+        node.remaining.store(node.dependencies, std::memory_order_relaxed);
+    }
+    for (size_t task = 0; task < graph.nodes_.size(); ++task) {
+        if (graph.nodes_[task].dependencies == 0) {
+            push({ run_task, &graph, static_cast<int>(task), 0, &counter });
+        }
+    }
+    wait(counter);
+}
+
+
+// Private
+
+
+void JobSystem::Queue::push(const Job& job) {
+    std::lock_guard lock(mutex_);
+    if (count_ == jobs_.size()) {
+        std::vector<Job> grown(jobs_.empty() ? 64 : jobs_.size() * 2);
+        for (size_t index = 0; index < count_; ++index) {
+            grown[index] = jobs_[(head_ + index) % jobs_.size()];
+        }
+        jobs_.swap(grown);
+        head_ = 0;
+    }
+    jobs_[(head_ + count_) % jobs_.size()] = job;
+    ++count_;
+}
+
+bool JobSystem::Queue::pop(Job& job) {
+    std::lock_guard lock(mutex_);
+    if (count_ == 0) {
+        return false;
+    }
+    --count_;
+    job = jobs_[(head_ + count_) % jobs_.size()];
+    return true;
+}
+
+bool JobSystem::Queue::steal(Job& job) {
+    std::lock_guard lock(mutex_);
+    if (count_ == 0) {
+        return false;
+    }
+    job = jobs_[head_];
+    head_ = (head_ + 1) % jobs_.size();
+    --count_;
+    return true;
+}
+
+
+size_t JobSystem::queue() const {
+    return current_ == this ? index_ : 0;
+}
+
+void JobSystem::push(const Job& job) {
+    job.counter->count_.fetch_add(1, std::memory_order_relaxed);
+    queues_[queue()]->push(job);
+    pending_.fetch_add(1);
+    if (sleeping_.load() > 0) {
+        {
+            std::lock_guard lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+    }
+}
+
+bool JobSystem::try_run(const size_t own) {
+    Job job;
+    bool found = queues_[own]->pop(job);
+    for (size_t offset = 1; not found and offset < queues_.size(); ++offset) {
+        found = queues_[(own + offset) % queues_.size()]->steal(job);
+    }
+    if (not found) {
+        return false;
+    }
+    pending_.fetch_sub(1);
+    job.invoke(job.context, job.first, job.last);
+    job.counter->count_.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::work(const size_t own) {
+    current_ = this;
+    index_ = own;
+    while (true) {
+        if (try_run(own)) {
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex_);
+        ++sleeping_;
+        wake_.wait(lock, [this] { return stopping_ or pending_.load() > 0; });
+        --sleeping_;
+        if (stopping_ and pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void JobSystem::run_task(const void* context, const int task, int) {
+    Graph& graph = *const_cast<Graph*>(static_cast<const Graph*>(context));
+    Graph::Node& node = graph.nodes_[task];
+    node.function();
+    for (const Graph::Task successor : node.successors) {
+        if (graph.nodes_[successor].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            graph.system_->push({ run_task, &graph, static_cast<int>(successor), 0, graph.counter_ });
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Persistent pool of worker threads, each with its own queue; idle workers steal from the others. A thread waiting
+// for its jobs runs queued jobs instead of blocking, so parallel_for and task graphs can be nested. Jobs must not
+// throw. Threads outside the pool share one queue.
+class JobSystem {
+public:
+
+    // Jobs of one fork/join still outstanding; wait on it before it goes out of scope
+    class Counter {
+    public:
+
+        Counter() = default;
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        [[nodiscard]] bool done() const;
+
+    private:
+
+        friend class JobSystem;
+        std::atomic<int> count_ = 0;
+    };
+
+    // Tasks with dependencies, built once and run any number of times
+    class Graph {
+    public:
+
+        using Task = size_t;
+
+        Task add(std::function<void()> function);
+        // Keeps after from starting before before has finished. Tasks can only depend on tasks added before them.
+        void precede(Task before, Task after);
+
+        [[nodiscard]] size_t size() const;
+
+    private:
+
+        friend class JobSystem;
+
+        struct Node {
+            std::function<void()> function;
+            std::vector<Task> successors;
+            int dependencies = 0;
+            std::atomic<int> remaining = 0;
+        };
+
+        std::deque<Node> nodes_;
+        JobSystem* system_ = nullptr;
+        Counter* counter_ = nullptr;
+    };
+
+    JobSystem();
+    explicit JobSystem(size_t workers);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    // Workers plus the calling thread
+    [[nodiscard]] size_t threads() const;
+
+    // Fork: function() runs on some thread and has to stay alive until the counter is waited on
+    template <typename Function>
+    void run(Counter& counter, const Function& function) {
+        push({ [](const void* context, int, int) { (*static_cast<const Function*>(context))(); }, &function, 0, 0, &counter });
+    }
+
+    // Join: runs queued jobs until every job counted has finished
+    void wait(Counter&);
+
+    // Calls function(first, last) over [begin, end) split into chunks of at least grain, returning when all are done
+    template <typename Function>
+    void parallel_for(const int begin, const int end, const Function& function, const int grain = 1) {
+        if (end <= begin) {
+            return;
+        }
+        const int count = end - begin;
+        const int target = static_cast<int>(threads()) * 4;
+        const int chunk = (count + target - 1) / target > grain ? (count + target - 1) / target : grain;
+        if (chunk >= count) {
+            function(begin, end);
+            return;
+        }
+        Counter counter;
+        for (int first = begin + chunk; first < end; first += chunk) {
+            push({
+                [](const void* context, const int first, const int last) { (*static_cast<const Function*>(context))(first, last); },
+                &function,
+                first,
+                end - first > chunk ? first + chunk : end,
+                &counter,
+            });
+        }
+        function(begin, begin + chunk);
+        wait(counter);
+    }
+
+    // Runs every task of the graph once, each after the tasks preceding it, returning when all are done
+    void run(Graph&);
+
+private:
+
+    struct Job {
+        void (*invoke)(const void* context, int first, int last);
+        const void* context;
+        int first, last;
+        Counter* counter;
+    };
+
+    // Ring buffer of jobs; the owner takes the newest, thieves the oldest
+    class Queue {
+    public:
+
+        void push(const Job&);
+        bool pop(Job&);
+        bool steal(Job&);
+
+    private:
+
+        std::mutex mutex_;
+        std::vector<Job> jobs_;
+        size_t head_ = 0, count_ = 0;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<int> pending_ = 0;
+    std::atomic<int> sleeping_ = 0;
+    std::atomic<bool> stopping_ = false;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+
+    inline static thread_local const JobSystem* current_ = nullptr;
+    inline static thread_local size_t index_ = 0;
+
+    [[nodiscard]] size_t queue() const;
+    void push(const Job&);
+    bool try_run(size_t queue);
+    void work(size_t queue);
+    static void run_task(const void* graph, int task, int);
+};
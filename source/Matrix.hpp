@@ -0,0 +1,258 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Vector.hpp"
+
+
+// Row-major 3x3 matrix, used for 2D affine transforms of Coordinates (implicit w = 1)
+template <typename type>
+struct Matrix3 {
+
+    std::array<type, 9> elements;
+
+    constexpr Matrix3() : elements{} {}
+    constexpr Matrix3(const std::array<type, 9>& elements) : elements(elements) {}
+
+    constexpr type& operator()(const size_t row, const size_t column) { return elements[row * 3 + column]; }
+    constexpr type operator()(const size_t row, const size_t column) const { return elements[row * 3 + column]; }
+
+    static constexpr Matrix3 identity() {
+        return std::array<type, 9>{
+            1, 0, 0,
+            0, 1, 0,
+            0, 0, 1,
+        };
+    }
+
+    static constexpr Matrix3 translation(const Coordinate<type>& offset) {
+        return std::array<type, 9>{
+            1, 0, offset.x,
+            0, 1, offset.y,
+            0, 0, 1,
+        };
+    }
+
+    static constexpr Matrix3 scale(const Coordinate<type>& factor) {
+        return std::array<type, 9>{
+            factor.x, 0,        0,
+            0,        factor.y, 0,
+            0,        0,        1,
+        };
+    }
+
+    static constexpr Matrix3 shear(const Coordinate<type>& factor) {
+        return std::array<type, 9>{
+            1,        factor.x, 0,
+            factor.y, 1,        0,
+            0,        0,        1,
+        };
+    }
+
+    static Matrix3 rotation(const type angle) {
+        const type cos = static_cast<type>(std::cos(angle));
+        const type sin = static_cast<type>(std::sin(angle));
+        return std::array<type, 9>{
+            cos, -sin, 0,
+            sin,  cos, 0,
+            0,    0,   1,
+        };
+    }
+
+    constexpr Matrix3 transposed() const {
+        Matrix3 result;
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t column = 0; column < 3; ++column) {
+                result(column, row) = (*this)(row, column);
+            }
+        }
+        return result;
+    }
+
+    constexpr Matrix3& operator*=(const Matrix3& other) { return *this = *this * other; }
+
+    friend constexpr Matrix3 operator*(const Matrix3& lhs, const Matrix3& rhs) {
+        Matrix3 result;
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t column = 0; column < 3; ++column) {
+                for (size_t k = 0; k < 3; ++k) {
+                    result(row, column) += lhs(row, k) * rhs(k, column);
+                }
+            }
+        }
+        return result;
+    }
+
+    friend constexpr Vector3<type> operator*(const Matrix3& lhs, const Vector3<type>& rhs) {
+        return {
+            lhs(0, 0) * rhs.x + lhs(0, 1) * rhs.y + lhs(0, 2) * rhs.z,
+            lhs(1, 0) * rhs.x + lhs(1, 1) * rhs.y + lhs(1, 2) * rhs.z,
+            lhs(2, 0) * rhs.x + lhs(2, 1) * rhs.y + lhs(2, 2) * rhs.z,
+        };
+    }
+
+    friend constexpr Coordinate<type> operator*(const Matrix3& lhs, const Coordinate<type>& rhs) {
+        return {
+            lhs(0, 0) * rhs.x + lhs(0, 1) * rhs.y + lhs(0, 2),
+            lhs(1, 0) * rhs.x + lhs(1, 1) * rhs.y + lhs(1, 2),
+        };
+    }
+
+    friend constexpr bool operator==(const Matrix3& lhs, const Matrix3& rhs) = default;
+};
+
+
+// Row-major 4x4 matrix, used for 3D affine transforms and projections of Vector3s (implicit w = 1)
+template <typename type>
+struct Matrix4 {
+
+    std::array<type, 16> elements;
+
+    constexpr Matrix4() : elements{} {}
+    constexpr Matrix4(const std::array<type, 16>& elements) : elements(elements) {}
+
+    constexpr type& operator()(const size_t row, const size_t column) { return elements[row * 4 + column]; }
+    constexpr type operator()(const size_t row, const size_t column) const { return elements[row * 4 + column]; }
+
+    static constexpr Matrix4 identity() {
+        return std::array<type, 16>{
+            1, 0, 0, 0,
+            0, 1, 0, 0,
+            0, 0, 1, 0,
+            0, 0, 0, 1,
+        };
+    }
+
+    static constexpr Matrix4 translation(const Vector3<type>& offset) {
+        return std::array<type, 16>{
+            1, 0, 0, offset.x,
+            0, 1, 0, offset.y,
+            0, 0, 1, offset.z,
+            0, 0, 0, 1,
+        };
+    }
+
+    static constexpr Matrix4 scale(const Vector3<type>& factor) {
+        return std::array<type, 16>{
+            factor.x, 0,        0,        0,
+            0,        factor.y, 0,        0,
+            0,        0,        factor.z, 0,
+            0,        0,        0,        1,
+        };
+    }
+
+    static Matrix4 rotation_x(const type angle) {
+        const type cos = static_cast<type>(std::cos(angle));
+        const type sin = static_cast<type>(std::sin(angle));
+        return std::array<type, 16>{
+            1, 0,    0,   0,
+            0, cos, -sin, 0,
+            0, sin,  cos, 0,
+            0, 0,    0,   1,
+        };
+    }
+
+    static Matrix4 rotation_y(const type angle) {
+        const type cos = static_cast<type>(std::cos(angle));
+        const type sin = static_cast<type>(std::sin(angle));
+        return std::array<type, 16>{
+             cos, 0, sin, 0,
+             0,   1, 0,   0,
+            -sin, 0, cos, 0,
+             0,   0, 0,   1,
+        };
+    }
+
+    static Matrix4 rotation_z(const type angle) {
+        const type cos = static_cast<type>(std::cos(angle));
+        const type sin = static_cast<type>(std::sin(angle));
+        return std::array<type, 16>{
+            cos, -sin, 0, 0,
+            sin,  cos, 0, 0,
+            0,    0,   1, 0,
+            0,    0,   0, 1,
+        };
+    }
+
+    // Maps the view frustum to clip space with depth in [0, 1], looking down +z
+    static Matrix4 perspective(const type field_of_view, const type aspect_ratio, const type near_plane, const type far_plane) {
+        const type focal_length = static_cast<type>(1.0 / std::tan(field_of_view / 2.0));
+        const type depth = far_plane / (far_plane - near_plane);
+        return std::array<type, 16>{
+            focal_length / aspect_ratio, 0,            0,     0,
+            0,                           focal_length, 0,     0,
+            0,                           0,            depth, -near_plane * depth,
+            0,                           0,            1,     0,
+        };
+    }
+
+    static constexpr Matrix4 orthographic(const Vector3<type>& minimum, const Vector3<type>& maximum) {
+        const Vector3<type> size = maximum - minimum;
+        return std::array<type, 16>{
+            2 / size.x, 0,          0,          -(maximum.x + minimum.x) / size.x,
+            0,          2 / size.y, 0,          -(maximum.y + minimum.y) / size.y,
+            0,          0,          1 / size.z, -minimum.z / size.z,
+            0,          0,          0,          1,
+        };
+    }
+
+    // Maps normalised device coordinates ([-1, 1], y up) to screen coordinates ([0, dimensions), y down)
+    static constexpr Matrix4 viewport(const Coordinate<type>& dimensions) {
+        return std::array<type, 16>{
+            dimensions.x / 2, 0,                 0, dimensions.x / 2,
+            0,                -dimensions.y / 2, 0, dimensions.y / 2,
+            0,                0,                 1, 0,
+            0,                0,                 0, 1,
+        };
+    }
+
+    constexpr Matrix4 transposed() const {
+        Matrix4 result;
+        for (size_t row = 0; row < 4; ++row) {
+            for (size_t column = 0; column < 4; ++column) {
+                result(column, row) = (*this)(row, column);
+            }
+        }
+        return result;
+    }
+
+    constexpr Matrix4& operator*=(const Matrix4& other) { return *this = *this * other; }
+
+    friend constexpr Matrix4 operator*(const Matrix4& lhs, const Matrix4& rhs) {
+        Matrix4 result;
+        for (size_t row = 0; row < 4; ++row) {
+            for (size_t column = 0; column < 4; ++column) {
+                for (size_t k = 0; k < 4; ++k) {
+                    result(row, column) += lhs(row, k) * rhs(k, column);
+                }
+            }
+        }
+        return result;
+    }
+
+    friend constexpr Vector4<type> operator*(const Matrix4& lhs, const Vector4<type>& rhs) {
+        return {
+            lhs(0, 0) * rhs.x + lhs(0, 1) * rhs.y + lhs(0, 2) * rhs.z + lhs(0, 3) * rhs.w,
+            lhs(1, 0) * rhs.x + lhs(1, 1) * rhs.y + lhs(1, 2) * rhs.z + lhs(1, 3) * rhs.w,
+            lhs(2, 0) * rhs.x + lhs(2, 1) * rhs.y + lhs(2, 2) * rhs.z + lhs(2, 3) * rhs.w,
+            lhs(3, 0) * rhs.x + lhs(3, 1) * rhs.y + lhs(3, 2) * rhs.z + lhs(3, 3) * rhs.w,
+        };
+    }
+
+    friend constexpr Vector3<type> operator*(const Matrix4& lhs, const Vector3<type>& rhs) {
+        return {
+            lhs(0, 0) * rhs.x + lhs(0, 1) * rhs.y + lhs(0, 2) * rhs.z + lhs(0, 3),
+            lhs(1, 0) * rhs.x + lhs(1, 1) * rhs.y + lhs(1, 2) * rhs.z + lhs(1, 3),
+            lhs(2, 0) * rhs.x + lhs(2, 1) * rhs.y + lhs(2, 2) * rhs.z + lhs(2, 3),
+        };
+    }
+
+    // Transforms a point and applies the perspective divide
+    constexpr Vector3<type> project(const Vector3<type>& point) const {
+        const Vector4<type> clip = *this * Vector4<type>(point, 1);
+        return clip.xyz() / clip.w;
+    }
+
+    friend constexpr bool operator==(const Matrix4& lhs, const Matrix4& rhs) = default;
+};
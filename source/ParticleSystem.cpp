@@ -0,0 +1,243 @@
+#include "pch.hpp"
+
+#include "ParticleSystem.hpp"
+
+
+void ParticleSystem::Particles::resize(const size_t size) {
+    for (std::vector<float>* field : { &x, &y, &velocity_x, &velocity_y, &age, &ageing }) {
+        field->resize(size);
+    }
+}
+
+
+ParticleSystem::ParticleSystem(JobSystem& jobs) : jobs_(jobs) {
+    set_ramp({
+        Pixel(Pixel::Colour::White, Pixel::Shade::Full),
+        Pixel(Pixel::Colour::Yellow, Pixel::Shade::Full),
+        Pixel(Pixel::Colour::Yellow, Pixel::Shade::ThreeQuarters),
+        Pixel(Pixel::Colour::Red, Pixel::Shade::Half),
+        Pixel(Pixel::Colour::DarkRed, Pixel::Shade::Quarter),
+    });
+}
+
+size_t ParticleSystem::size() const {
+    return size_;
+}
+
+size_t ParticleSystem::capacity() const {
+    return capacity_;
+}
+
+void ParticleSystem::set_capacity(const size_t capacity) {
+    capacity_ = capacity;
+    size_ = size_ < capacity ? size_ : capacity;
+}
+
+void ParticleSystem::set_ramp(const std::vector<Pixel>& ramp) {
+    if (ramp.empty() or ramp.size() > 255) {
+        throw std::invalid_argument("Particle ramps need between 1 and 255 cells");
+    }
+    ramp_.clear();
+    for (const Pixel& pixel : ramp) {
+        ramp_.push_back(pixel.char_info());
+    }
+}
+
+void ParticleSystem::set_gravity(const Coordinate<float>& gravity) {
+    gravity_ = gravity;
+}
+
+void ParticleSystem::set_drag(const float drag) {
+    drag_ = drag;
+}
+
+size_t ParticleSystem::add_emitter(const Emitter& emitter) {
+    emitters_.push_back(emitter);
+    owed_.push_back(0.0f);
+    return emitters_.size() - 1;
+}
+
+ParticleSystem::Emitter& ParticleSystem::emitter(const size_t index) {
+    if (index >= emitters_.size()) {
+        throw std::out_of_range("Emitter " + std::to_string(index) + " does not exist");
+    }
+    return emitters_[index];
+}
+
+void ParticleSystem::clear_emitters() {
+    emitters_.clear();
+    owed_.clear();
+}
+
+void ParticleSystem::emit(const Emitter& emitter, const size_t count) {
+    spawn(emitter, count);
+}
+
+void ParticleSystem::clear() {
+    size_ = 0;
+}
+
+void ParticleSystem::update(const double frame_time) {
+    const auto step = static_cast<float>(frame_time);
+    const float damping = drag_ * step < 1.0f ? 1.0f - drag_ * step : 0.0f;
+    const Coordinate<float> acceleration = gravity_ * step;
+
+    const size_t chunks = (size_ + chunk_size - 1) / chunk_size;
+    alive_.resize(chunks);
+    if (survivors_.x.size() < particles_.x.size()) {
+        survivors_.resize(particles_.x.size());
+    }
+
+    jobs_.parallel_for(0, static_cast<int>(chunks), [&](const int first, const int last) {
+        float* const x = particles_.x.data();
+        float* const y = particles_.y.data();
+        float* const velocity_x = particles_.velocity_x.data();
+        float* const velocity_y = particles_.velocity_y.data();
+        float* const age = particles_.age.data();
+        const float* const ageing = particles_.ageing.data();
+        for (size_t chunk = static_cast<size_t>(first); chunk < static_cast<size_t>(last); ++chunk) {
+            const size_t begin = chunk * chunk_size;
+            const size_t end = begin + chunk_size < size_ ? begin + chunk_size : size_;
+            for (size_t particle = begin; particle < end; ++particle) {
+                x[particle] += velocity_x[particle] * step;
+                y[particle] += velocity_y[particle] * step;
+                velocity_x[particle] = velocity_x[particle] * damping + acceleration.x;
+                velocity_y[particle] = velocity_y[particle] * damping + acceleration.y;
+                age[particle] += ageing[particle] * step;
+            }
+            size_t alive = 0;
+            for (size_t particle = begin; particle < end; ++particle) {
+                alive += age[particle] < 1.0f;
+            }
+            alive_[chunk] = alive;
+        }
+    });
+
+    // Where each chunk's survivors start
+    size_t survivors = 0;
+    for (size_t& alive : alive_) {
+        const size_t count = alive;
+        alive = survivors;
+        survivors += count;
+    }
+
+    jobs_.parallel_for(0, static_cast<int>(chunks), [&](const int first, const int last) {
+        const std::array<const std::vector<float>*, 6> sources = { &particles_.x, &particles_.y, &particles_.velocity_x, &particles_.velocity_y, &particles_.age, &particles_.ageing };
+        const std::array<std::vector<float>*, 6> destinations = { &survivors_.x, &survivors_.y, &survivors_.velocity_x, &survivors_.velocity_y, &survivors_.age, &survivors_.ageing };
+        const float* const age = particles_.age.data();
+        for (size_t chunk = static_cast<size_t>(first); chunk < static_cast<size_t>(last); ++chunk) {
+            const size_t begin = chunk * chunk_size;
+            const size_t end = begin + chunk_size < size_ ? begin + chunk_size : size_;
+            const size_t count = (chunk + 1 < chunks ? alive_[chunk + 1] : survivors) - alive_[chunk];
+            for (size_t field = 0; field < sources.size(); ++field) {
+                const float* const source = sources[field]->data();
+                float* const destination = destinations[field]->data() + alive_[chunk];
+                if (count == end - begin) {
+                    std::copy(source + begin, source + end, destination);
+                    continue;
+                }
+                size_t written = 0;
+                for (size_t particle = begin; particle < end; ++particle) {
+                    if (age[particle] < 1.0f) {
+                        destination[written++] = source[particle];
+                    }
+                }
+            }
+        }
+    });
+
+    std::swap(particles_, survivors_);
+    size_ = survivors;
+
+    for (size_t index = 0; index < emitters_.size(); ++index) {
+        if (not emitters_[index].active) {
+            continue;
+        }
+        owed_[index] += emitters_[index].rate * step;
+        const auto count = static_cast<size_t>(owed_[index]);
+        owed_[index] -= static_cast<float>(count);
+        spawn(emitters_[index], count);
+    }
+}
+
+void ParticleSystem::draw(Surface& surface, const Coordinate<float>& camera) {
+    const int width = surface.width(), height = surface.height();
+    const size_t cells = static_cast<size_t>(width) * height;
+    if (size_ == 0 or cells == 0) {
+        return;
+    }
+    const size_t chunks = (size_ + chunk_size - 1) / chunk_size;
+    const size_t bands = jobs_.threads() < chunks ? jobs_.threads() : chunks;
+    if (levels_.size() < bands * cells) {
+        levels_.resize(bands * cells);
+    }
+    const auto levels = static_cast<float>(ramp_.size());
+    const auto bounds = Coordinate<float>(static_cast<float>(width), static_cast<float>(height));
+
+    jobs_.parallel_for(0, static_cast<int>(bands), [&](const int first, const int last) {
+        const float* const x = particles_.x.data();
+        const float* const y = particles_.y.data();
+        const float* const age = particles_.age.data();
+        for (size_t band = static_cast<size_t>(first); band < static_cast<size_t>(last); ++band) {
+            uint8_t* const buffer = levels_.data() + band * cells;
+            std::fill_n(buffer, cells, uint8_t(0));
+            const size_t begin = size_ * band / bands, end = size_ * (band + 1) / bands;
+            for (size_t particle = begin; particle < end; ++particle) {
+                const float cell_x = x[particle] - camera.x, cell_y = y[particle] - camera.y;
+                if (cell_x >= 0.0f and cell_y >= 0.0f and cell_x < bounds.x and cell_y < bounds.y) {
+                    const size_t cell = static_cast<size_t>(cell_y) * width + static_cast<size_t>(cell_x);
+                    const auto level = static_cast<uint8_t>(levels - static_cast<float>(static_cast<int>(age[particle] * levels)));
+                    buffer[cell] = level > buffer[cell] ? level : buffer[cell];
+                }
+            }
+        }
+    });
+
+    // Merges the bands into the first, row by row, and writes the rows' cells
+    jobs_.parallel_for(0, height, [&](const int first, const int last) {
+        for (int row = first; row < last; ++row) {
+            uint8_t* const merged = levels_.data() + static_cast<size_t>(row) * width;
+            for (size_t band = 1; band < bands; ++band) {
+                const uint8_t* const buffer = merged + band * cells;
+                for (int column = 0; column < width; ++column) {
+                    merged[column] = buffer[column] > merged[column] ? buffer[column] : merged[column];
+                }
+            }
+            CHAR_INFO* const destination = surface.row(row);
+            for (int column = 0; column < width; ++column) {
+                if (merged[column] != 0) {
+                    destination[column] = ramp_[ramp_.size() - merged[column]];
+                }
+            }
+        }
+    }, 4);
+}
+
+
+// Private
+
+
+void ParticleSystem::spawn(const Emitter& emitter, size_t count) {
+    if (size_ >= capacity_) {
+        return;
+    }
+    count = count < capacity_ - size_ ? count : capacity_ - size_;
+    if (particles_.x.size() < size_ + count) {
+        const size_t grown = particles_.x.size() * 2 > size_ + count ? particles_.x.size() * 2 : size_ + count;
+        particles_.resize(grown < capacity_ ? grown : capacity_);
+    }
+    for (size_t particle = size_; particle < size_ + count; ++particle) {
+        particles_.x[particle] = emitter.position.x + jitter(emitter.spread.x);
+        particles_.y[particle] = emitter.position.y + jitter(emitter.spread.y);
+        particles_.velocity_x[particle] = emitter.velocity.x + jitter(emitter.velocity_spread.x);
+        particles_.velocity_y[particle] = emitter.velocity.y + jitter(emitter.velocity_spread.y);
+        const float lifetime = emitter.lifetime + jitter(emitter.lifetime_spread);
+        particles_.age[particle] = 0.0f;
+        particles_.ageing[particle] = 1.0f / (lifetime > 0.001f ? lifetime : 0.001f);
+    }
+    size_ += count;
+}
+
+float ParticleSystem::jitter(const float spread) {
+    return spread == 0.0f ? 0.0f : std::uniform_real_distribution<float>(-1.0f, 1.0f)(random_) * spread;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Pixel.hpp"
+#include "Surface.hpp"
+#include "JobSystem.hpp"
+
+
+// Particles stored as structure of arrays, one array per field, so integrating them is a handful of straight loops
+// the compiler vectorizes. Updating runs in fixed chunks across the job system and compacts the survivors into a
+// second set of arrays. Drawing splats every chunk into its own buffer of ramp levels, which are merged keeping the
+// youngest particle in each cell, so the result does not depend on the order the threads ran in.
+class ParticleSystem {
+public:
+
+    struct Emitter {
+        Coordinate<float> position;
+        // Particles start up to spread away from the position along each axis
+        Coordinate<float> spread;
+        // Cells per second
+        Coordinate<float> velocity;
+        Coordinate<float> velocity_spread;
+        // Seconds
+        float lifetime = 1.0f;
+        float lifetime_spread = 0.0f;
+        // Particles per second, while active
+        float rate = 0.0f;
+        bool active = true;
+    };
+
+    explicit ParticleSystem(JobSystem&);
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+    ParticleSystem(ParticleSystem&&) = delete;
+    ParticleSystem& operator=(ParticleSystem&&) = delete;
+
+    [[nodiscard]] size_t size() const;
+    // Particles emitted past the capacity are dropped
+    [[nodiscard]] size_t capacity() const;
+    void set_capacity(size_t);
+
+    // Cells particles are drawn as over their life, from birth to death
+    void set_ramp(const std::vector<Pixel>&);
+    // Acceleration in cells per second squared
+    void set_gravity(const Coordinate<float>&);
+    // Fraction of velocity lost per second
+    void set_drag(float);
+
+    size_t add_emitter(const Emitter&);
+    [[nodiscard]] Emitter& emitter(size_t);
+    void clear_emitters();
+
+    // Bursts, for explosions: count particles at once, whatever the emitter's rate
+    void emit(const Emitter&, size_t count);
+    void clear();
+
+    // Ages and moves every particle, removes the dead, then runs the emitters
+    void update(double frame_time);
+
+    // Particles at camera are drawn at the surface's top left
+    void draw(Surface&, const Coordinate<float>& camera = { 0.0f, 0.0f });
+
+private:
+
+    static constexpr size_t chunk_size = 16384;
+
+    // Age runs from 0 at birth to 1 at death, ageing is the reciprocal of the lifetime
+    struct Particles {
+        std::vector<float> x, y, velocity_x, velocity_y, age, ageing;
+
+        void resize(size_t);
+    };
+
+    JobSystem& jobs_;
+    Particles particles_, survivors_;
+    size_t size_ = 0;
+    size_t capacity_ = 1 << 20;
+    std::vector<size_t> alive_;
+
+    std::vector<CHAR_INFO> ramp_;
+    Coordinate<float> gravity_ = { 0.0f, 0.0f };
+    float drag_ = 0.0f;
+
+    std::vector<Emitter> emitters_;
+    // Fractions of a particle carried over between updates
+    std::vector<float> owed_;
+    std::minstd_rand random_;
+
+    // One buffer of levels per band of particles; 0 is empty, the youngest particles have the highest level
+    std::vector<uint8_t> levels_;
+
+    void spawn(const Emitter&, size_t count);
+    [[nodiscard]] float jitter(float spread);
+};
@@ -22,6 +22,26 @@ std::array<Pixel, 13> luminance_to_pixel = {
     Pixel(White),
 };
 
+// Greys match the steps of luminance_to_pixel so that Pixel(luminance(pixel)) maps the ramp onto itself
+std::array<double, 16> colour_to_luminance = {
+    0.0,
+    0.057,
+    0.294,
+    0.351,
+    0.150,
+    0.206,
+    0.443,
+    2.0 / 3.0,
+    1.0 / 3.0,
+    0.114,
+    0.587,
+    0.701,
+    0.299,
+    0.413,
+    0.886,
+    1.0,
+};
+
 
 Pixel::Pixel() : colour(Colour::White), shade(Shade::Full) {}
 
@@ -46,73 +66,104 @@ Pixel::Pixel(const double luminance) {
     }
 }
 
+Pixel::Pixel(const CHAR_INFO& char_info) : colour(static_cast<Colour>(char_info.Attributes)), shade(static_cast<Shade>(char_info.Char.UnicodeChar)) {}
+
+CHAR_INFO Pixel::char_info() const {
+    CHAR_INFO char_info;
+    char_info.Char.UnicodeChar = static_cast<WCHAR>(shade);
+    char_info.Attributes = static_cast<WORD>(colour);
+    return char_info;
+}
+
 
 Pixel::Colour background(Pixel::Colour colour) {
     return static_cast<Pixel::Colour>(static_cast<WORD>(colour) << 4);
 }
 
-std::unordered_map<Pixel::Colour, std::string> colour_to_string = {
-    { Black, "black" },
-    { DarkBlue, "dark_blue" },
-    { DarkGreen, "dark_green" },
-    { DarkCyan, "dark_cyan" },
-    { DarkRed, "dark_red" },
-    { Purple, "purple" },
-    { Brown, "brown" },
-    { LightGrey, "light_grey" },
-    { DarkGrey, "dark_grey" },
-    { Blue, "blue" },
-    { Green, "green" },
-    { Cyan, "cyan" },
-    { Red, "red" },
-    { Magenta, "magenta" },
-    { Yellow, "yellow" },
-    { White, "white" },
-};
+double luminance(const Pixel::Colour colour) {
+    return colour_to_luminance[static_cast<WORD>(colour) & 0x000F];
+}
+
+double luminance(const Pixel& pixel) {
+    double coverage;
+    switch (pixel.shade) {
+        case Empty: coverage = 0.0; break;
+        case Quarter: coverage = 0.25; break;
+        case Half: coverage = 0.5; break;
+        case ThreeQuarters: coverage = 0.75; break;
+        case Full: coverage = 1.0; break;
+        default: coverage = 0.5; break;
+    }
+    const WORD colour = static_cast<WORD>(pixel.colour);
+    return colour_to_luminance[colour & 0x000F] * coverage + colour_to_luminance[(colour >> 4) & 0x000F] * (1.0 - coverage);
+}
 
-std::unordered_map<std::string, Pixel::Colour> string_to_colour = {
-    { "black", Black },
-    { "dark_blue", DarkBlue },
-    { "dark_green", DarkGreen },
-    { "dark_cyan", DarkCyan },
-    { "dark_red", DarkRed },
-    { "purple", Purple },
-    { "brown", Brown },
-    { "light_grey", LightGrey },
-    { "dark_grey", DarkGrey },
-    { "blue", Blue },
-    { "green", Green },
-    { "cyan", Cyan },
-    { "red", Red },
-    { "magenta", Magenta },
-    { "yellow", Yellow },
-    { "white", White },
+constexpr std::array<std::string_view, 16> colour_names = {
+    "black",
+    "dark_blue",
+    "dark_green",
+    "dark_cyan",
+    "dark_red",
+    "purple",
+    "brown",
+    "light_grey",
+    "dark_grey",
+    "blue",
+    "green",
+    "cyan",
+    "red",
+    "magenta",
+    "yellow",
+    "white",
 };
 
-std::unordered_map<Pixel::Shade, std::string> shade_to_string = {
+constexpr std::array<std::pair<Pixel::Shade, std::string_view>, 5> shade_names = { {
     { Empty, "empty" },
     { Quarter, "quarter" },
     { Half, "half" },
     { ThreeQuarters, "three_quarters" },
     { Full, "full" },
-};
-
-std::unordered_map<std::string, Pixel::Shade> string_to_shade = {
-    { "empty", Empty },
-    { "quarter", Quarter },
-    { "half", Half },
-    { "three_quarters", ThreeQuarters },
-    { "full", Full },
-};
+} };
 
+// A background other than black follows the foreground as "foreground/background", so files written before
+// backgrounds were kept still read as black backgrounds. Characters other than the named shades, such as text, are
+// written as their code in hexadecimal, "u+0041"
 std::ostream& operator<<(std::ostream& stream, const Pixel& pixel) {
-    return stream << colour_to_string[pixel.colour] << ' ' << shade_to_string[pixel.shade];
+    const WORD colour = static_cast<WORD>(pixel.colour);
+    stream << colour_names[colour & 0x000F];
+    if ((colour >> 4) & 0x000F) {
+        stream << '/' << colour_names[(colour >> 4) & 0x000F];
+    }
+    stream << ' ';
+    for (const auto& [shade, name] : shade_names) {
+        if (shade == pixel.shade) {
+            return stream << name;
+        }
+    }
+    return stream << std::format("u+{:04x}", static_cast<WORD>(pixel.shade));
 }
 
+// Names are all short enough for the small string buffer, so reading does not allocate
 std::istream& operator>>(std::istream& stream, Pixel& pixel) {
     std::string colour, shade;
-    stream >> colour >> shade;
-    pixel = Pixel(string_to_colour[colour], string_to_shade[shade]);
+    if (not (stream >> colour >> shade)) {
+        return stream;
+    }
+    const size_t separator = colour.find('/');
+    const std::string_view foreground = std::string_view(colour).substr(0, separator);
+    const std::string_view background_name = separator == std::string::npos ? colour_names.front() : std::string_view(colour).substr(separator + 1);
+    const auto found_foreground = std::find(colour_names.begin(), colour_names.end(), foreground);
+    const auto found_background = std::find(colour_names.begin(), colour_names.end(), background_name);
+    const auto found_shade = std::find_if(shade_names.begin(), shade_names.end(), [&](const auto& entry) { return entry.second == shade; });
+    WORD code = 0;
+    const bool coded = shade.size() == 6 and shade.starts_with("u+")
+        and std::from_chars(shade.data() + 2, shade.data() + shade.size(), code, 16).ptr == shade.data() + shade.size();
+    if (found_foreground == colour_names.end() or found_background == colour_names.end() or (found_shade == shade_names.end() and not coded)) {
+        stream.setstate(std::ios::failbit);
+        return stream;
+    }
+    pixel = Pixel(static_cast<Pixel::Colour>(found_foreground - colour_names.begin()), static_cast<Pixel::Colour>(found_background - colour_names.begin()),
+        found_shade != shade_names.end() ? found_shade->first : static_cast<Pixel::Shade>(code));
     return stream;
 }
 
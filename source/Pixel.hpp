@@ -38,10 +38,16 @@ struct Pixel {
     Pixel(const Colour, const Shade);
     Pixel(const Colour foreground, const Colour background, const Shade);
     Pixel(const double luminance);
+    explicit Pixel(const CHAR_INFO&);
+
+    CHAR_INFO char_info() const;
 };
 
 Pixel::Colour background(Pixel::Colour);
 
+double luminance(Pixel::Colour);
+double luminance(const Pixel&);
+
 std::ostream& operator<<(std::ostream&, const Pixel&);
 std::istream& operator>>(std::istream&, Pixel&);
 
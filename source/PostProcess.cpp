@@ -0,0 +1,163 @@
+#include "pch.hpp"
+
+#include "PostProcess.hpp"
+
+using enum Pixel::Shade;
+
+
+namespace {
+
+    constexpr std::array<Pixel::Shade, 5> shades = { Empty, Quarter, Half, ThreeQuarters, Full };
+    constexpr int Character = 5;
+
+    int shade_index(const WCHAR glyph) {
+        switch (static_cast<Pixel::Shade>(glyph)) {
+            case Empty: return 0;
+            case Quarter: return 1;
+            case Half: return 2;
+            case ThreeQuarters: return 3;
+            case Full: return 4;
+            default: return Character;
+        }
+    }
+
+    Pixel::Colour grey(const double luminance) {
+        constexpr std::array<Pixel::Colour, 4> greys = { Pixel::Colour::Black, Pixel::Colour::DarkGrey, Pixel::Colour::LightGrey, Pixel::Colour::White };
+        const int index = static_cast<int>(luminance * 3.0 + 0.5);
+        return greys[index < 0 ? 0 : index > 3 ? 3 : index];
+    }
+
+    // Indexed by the low attribute byte and shade index. Shades are replaced by the ramp; text keeps its glyph and is
+    // recoloured in the nearest greys.
+    using FadeTable = std::array<CHAR_INFO, 256 * 6>;
+
+    std::shared_ptr<const FadeTable> fade_table(const double factor) {
+        auto table = std::make_shared<FadeTable>();
+        for (WORD attributes = 0; attributes < 256; ++attributes) {
+            const auto colour = static_cast<Pixel::Colour>(attributes);
+            for (int shade = 0; shade < Character; ++shade) {
+                (*table)[attributes * 6 + shade] = Pixel(luminance(Pixel(colour, shades[shade])) * factor).char_info();
+            }
+            const auto foreground = static_cast<Pixel::Colour>(attributes & 0x0F);
+            const auto background_colour = static_cast<Pixel::Colour>(attributes >> 4);
+            (*table)[attributes * 6 + Character].Char.UnicodeChar = 0;
+            (*table)[attributes * 6 + Character].Attributes = static_cast<WORD>(grey(luminance(foreground) * factor) | background(grey(luminance(background_colour) * factor)));
+        }
+        return table;
+    }
+
+    void fade_cell(const FadeTable& table, CHAR_INFO& cell) {
+        const int shade = shade_index(cell.Char.UnicodeChar);
+        const CHAR_INFO& faded = table[(cell.Attributes & 0xFF) * 6 + shade];
+        cell.Attributes = (cell.Attributes & 0xFF00) | faded.Attributes;
+        if (shade != Character) {
+            cell.Char.UnicodeChar = faded.Char.UnicodeChar;
+        }
+    }
+
+    float cell_luminance(const CHAR_INFO& cell) {
+        const int shade = shade_index(cell.Char.UnicodeChar);
+        return static_cast<float>(luminance(Pixel(static_cast<Pixel::Colour>(cell.Attributes & 0xFF), shade == Character ? Half : shades[shade])));
+    }
+}
+
+
+PostProcess::PostProcess(JobSystem& jobs) : jobs_(jobs) {}
+
+
+void PostProcess::remap(const std::array<Pixel::Colour, 16>& palette) {
+    std::array<WORD, 256> table;
+    for (WORD attributes = 0; attributes < 256; ++attributes) {
+        table[attributes] = static_cast<WORD>(palette[attributes & 0x0F] | background(palette[attributes >> 4]));
+    }
+    add_cell_pass([table](CHAR_INFO& cell) {
+        cell.Attributes = (cell.Attributes & 0xFF00) | table[cell.Attributes & 0xFF];
+    });
+}
+
+void PostProcess::fade(const double factor) {
+    add_cell_pass([table = fade_table(factor)](CHAR_INFO& cell) {
+        fade_cell(*table, cell);
+    });
+}
+
+void PostProcess::scanlines(const double factor) {
+    add_row_pass([table = fade_table(factor)](CHAR_INFO* row, const int y, const int width) {
+        if (y % 2 == 1) {
+            for (int x = 0; x < width; ++x) {
+                fade_cell(*table, row[x]);
+            }
+        }
+    });
+}
+
+void PostProcess::blur() {
+    auto table = std::make_shared<std::array<float, 256 * 6>>();
+    auto ramp = std::make_shared<std::array<CHAR_INFO, 64>>();
+    for (WORD attributes = 0; attributes < 256; ++attributes) {
+        for (int shade = 0; shade < 6; ++shade) {
+            CHAR_INFO cell;
+            cell.Char.UnicodeChar = static_cast<WCHAR>(shade == Character ? Half : shades[shade]);
+            cell.Attributes = attributes;
+            (*table)[attributes * 6 + shade] = cell_luminance(cell);
+        }
+    }
+    for (size_t level = 0; level < ramp->size(); ++level) {
+        (*ramp)[level] = Pixel(static_cast<double>(level) / static_cast<double>(ramp->size() - 1)).char_info();
+    }
+    add_neighbourhood_pass([table, ramp](const Surface& snapshot, CHAR_INFO* row, const int y) {
+        const int width = snapshot.width();
+        const CHAR_INFO* rows[3] = {
+            snapshot.row(y > 0 ? y - 1 : y),
+            snapshot.row(y),
+            snapshot.row(y + 1 < snapshot.height() ? y + 1 : y),
+        };
+        auto sample = [&](const CHAR_INFO& cell) { return (*table)[(cell.Attributes & 0xFF) * 6 + shade_index(cell.Char.UnicodeChar)]; };
+        for (int x = 0; x < width; ++x) {
+            const int left = x > 0 ? x - 1 : x;
+            const int right = x + 1 < width ? x + 1 : x;
+            float sum = 0.0f;
+            for (const CHAR_INFO* source : rows) {
+                sum += sample(source[left]) + sample(source[x]) + sample(source[right]);
+            }
+            row[x] = (*ramp)[static_cast<size_t>(sum / 9.0f * static_cast<float>(ramp->size() - 1) + 0.5f)];
+        }
+    });
+}
+
+
+void PostProcess::clear() {
+    stages_.clear();
+}
+
+bool PostProcess::empty() const {
+    return stages_.empty();
+}
+
+
+void PostProcess::apply(Surface& surface) {
+    constexpr int minimum_rows = 8;
+    for (const auto& [snapshot, passes] : stages_) {
+        if (snapshot) {
+            if (snapshot_.dimensions() != surface.dimensions()) {
+                snapshot_ = Surface(surface.dimensions());
+            }
+            jobs_.parallel_for(0, surface.height(), [&](const int first, const int last) {
+                std::copy(surface.row(first), surface.row(last), snapshot_.row(first));
+            }, minimum_rows);
+        }
+        jobs_.parallel_for(0, surface.height(), [&](const int first, const int last) {
+            for (const Pass& pass : passes) {
+                pass(surface, snapshot_, first, last);
+            }
+        }, minimum_rows);
+    }
+}
+
+
+void PostProcess::add(Pass&& pass, const bool snapshot) {
+    if (snapshot or stages_.empty()) {
+        stages_.push_back({ snapshot, {} });
+    }
+    stages_.back().passes.push_back(std::move(pass));
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Pixel.hpp"
+#include "Surface.hpp"
+#include "JobSystem.hpp"
+
+
+// Chain of passes run over a surface between update() and render(). The surface is split into bands of rows that are
+// processed in parallel on the job system; each pass is called once per band, so the per-cell work inlines into a plain
+// loop. Cell and row passes are fused within a band. A neighbourhood pass reads a snapshot taken after every pass
+// before it.
+class PostProcess {
+public:
+
+    explicit PostProcess(JobSystem&);
+
+    // function(CHAR_INFO&)
+    template <typename Function>
+    void add_cell_pass(Function function) {
+        add([function](Surface& surface, const Surface&, const int first, const int last) {
+            const int width = surface.width();
+            for (int y = first; y < last; ++y) {
+                CHAR_INFO* row = surface.row(y);
+                for (int x = 0; x < width; ++x) {
+                    function(row[x]);
+                }
+            }
+        }, false);
+    }
+
+    // function(CHAR_INFO* row, int y, int width)
+    template <typename Function>
+    void add_row_pass(Function function) {
+        add([function](Surface& surface, const Surface&, const int first, const int last) {
+            for (int y = first; y < last; ++y) {
+                function(surface.row(y), y, surface.width());
+            }
+        }, false);
+    }
+
+    // function(const Surface& snapshot, CHAR_INFO* row, int y)
+    template <typename Function>
+    void add_neighbourhood_pass(Function function) {
+        add([function](Surface& surface, const Surface& snapshot, const int first, const int last) {
+            for (int y = first; y < last; ++y) {
+                function(snapshot, surface.row(y), y);
+            }
+        }, true);
+    }
+
+    // Replaces foreground and background colours through the palette
+    void remap(const std::array<Pixel::Colour, 16>& palette);
+    // Scales luminance and redraws through the greyscale luminance ramp
+    void fade(double factor);
+    // Fades every other row, for a CRT look
+    void scanlines(double factor);
+    // 3x3 box blur of luminance, drawn through the greyscale luminance ramp
+    void blur();
+
+    void clear();
+    [[nodiscard]] bool empty() const;
+
+    void apply(Surface&);
+
+private:
+
+    using Pass = std::function<void(Surface&, const Surface& snapshot, int first, int last)>;
+
+    struct Stage {
+        bool snapshot;
+        std::vector<Pass> passes;
+    };
+
+    JobSystem& jobs_;
+    std::vector<Stage> stages_;
+    Surface snapshot_;
+
+    void add(Pass&& pass, bool snapshot);
+};
@@ -0,0 +1,179 @@
+#include "pch.hpp"
+
+#include "Raycaster.hpp"
+
+
+Raycaster::Raycaster(const Coordinate<int>& map_dimensions, JobSystem& jobs, const double view_distance)
+    : jobs_(jobs), map_dimensions_(map_dimensions), cells_(static_cast<size_t>(map_dimensions.x) * map_dimensions.y, Empty), view_distance_(view_distance) {
+    if (map_dimensions.x <= 0 or map_dimensions.y <= 0) {
+        throw std::invalid_argument("Map dimensions must be positive");
+    }
+    for (size_t level = 0; level < ramp_.size(); ++level) {
+        ramp_[level] = Pixel(static_cast<double>(level) / static_cast<double>(ramp_.size() - 1)).char_info();
+    }
+}
+
+
+const Coordinate<int>& Raycaster::map_dimensions() const {
+    return map_dimensions_;
+}
+
+int Raycaster::cell(const Coordinate<int>& coordinate) const {
+    if (not coordinate.in_bounds(map_dimensions_)) {
+        throw std::out_of_range("Cell out of range");
+    }
+    return cells_[coordinate.to_index(map_dimensions_.x)];
+}
+
+void Raycaster::set_cell(const Coordinate<int>& coordinate, const int wall) {
+    if (not coordinate.in_bounds(map_dimensions_)) {
+        throw std::out_of_range("Cell out of range");
+    }
+    if (wall < Empty) {
+        throw std::invalid_argument("Walls are numbered from 1");
+    }
+    cells_[coordinate.to_index(map_dimensions_.x)] = wall;
+}
+
+void Raycaster::set_texture(const int wall, const SpriteView& texture) {
+    if (wall <= Empty) {
+        throw std::invalid_argument("Walls are numbered from 1");
+    }
+    if (texture.width() <= 0 or texture.height() <= 0) {
+        throw std::invalid_argument("Wall textures must not be empty");
+    }
+    if (textures_.size() < static_cast<size_t>(wall)) {
+        textures_.resize(wall);
+    }
+    Texture& stored = textures_[wall - 1];
+    stored.dimensions = texture.dimensions();
+    stored.luminance.resize(static_cast<size_t>(texture.width()) * texture.height());
+    for (int y = 0; y < texture.height(); ++y) {
+        const CHAR_INFO* row = texture.row(y);
+        for (int x = 0; x < texture.width(); ++x) {
+            stored.luminance[static_cast<size_t>(y) * texture.width() + x] = static_cast<float>(luminance(Pixel(row[x])));
+        }
+    }
+}
+
+void Raycaster::set_floor(const double luminance) {
+    floor_ = luminance;
+}
+
+void Raycaster::set_ceiling(const double luminance) {
+    ceiling_ = luminance;
+}
+
+
+void Raycaster::render(Surface& surface, const Camera& camera) {
+    const int height = surface.height();
+    backgrounds_.resize(height);
+    depth_.resize(surface.width());
+    // A row offset o cells from the horizon sees the floor or ceiling at distance height / 2o
+    const double horizon = 0.5 * height;
+    for (int y = 0; y < height; ++y) {
+        const double offset = static_cast<double>(y) + 0.5 - horizon;
+        const double distance = horizon / (offset < 0.0 ? -offset : offset);
+        backgrounds_[y] = shade((offset < 0.0 ? ceiling_ : floor_) * falloff(distance));
+    }
+    // Sixteen columns of depth or cells fill a cache line, so neighbouring chunks rarely write to the same one
+    jobs_.parallel_for(0, surface.width(), [&](const int first, const int last) {
+        for (int column = first; column < last; ++column) {
+            cast(surface, camera, column);
+        }
+    }, 16);
+}
+
+const std::vector<float>& Raycaster::depth() const {
+    return depth_;
+}
+
+
+// Private
+
+
+double Raycaster::falloff(const double distance) const {
+    const double factor = 1.0 - distance / view_distance_;
+    return factor > 0.0 ? factor : 0.0;
+}
+
+const CHAR_INFO& Raycaster::shade(const double luminance) const {
+    const double clamped = luminance < 0.0 ? 0.0 : luminance > 1.0 ? 1.0 : luminance;
+    return ramp_[static_cast<size_t>(clamped * static_cast<double>(ramp_.size() - 1) + 0.5)];
+}
+
+void Raycaster::cast(Surface& surface, const Camera& camera, const int column) {
+    const int width = surface.width(), height = surface.height();
+
+    const Coordinate<double> direction = { std::cos(camera.angle), std::sin(camera.angle) };
+    const double half_width = std::tan(0.5 * camera.field_of_view);
+    const double screen_x = 2.0 * (static_cast<double>(column) + 0.5) / static_cast<double>(width) - 1.0;
+    const Coordinate<double> ray = { direction.x - direction.y * half_width * screen_x, direction.y + direction.x * half_width * screen_x };
+
+    // DDA: step to whichever grid line, vertical or horizontal, the ray crosses next
+    Coordinate<int> map = { static_cast<int>(std::floor(camera.position.x)), static_cast<int>(std::floor(camera.position.y)) };
+    const Coordinate<double> delta = { ray.x == 0.0 ? 1e30 : std::abs(1.0 / ray.x), ray.y == 0.0 ? 1e30 : std::abs(1.0 / ray.y) };
+    const Coordinate<int> step = { ray.x < 0.0 ? -1 : 1, ray.y < 0.0 ? -1 : 1 };
+    Coordinate<double> side_distance = {
+        (ray.x < 0.0 ? camera.position.x - map.x : map.x + 1.0 - camera.position.x) * delta.x,
+        (ray.y < 0.0 ? camera.position.y - map.y : map.y + 1.0 - camera.position.y) * delta.y,
+    };
+    bool horizontal = false;
+    int wall = Empty;
+    while (wall == Empty) {
+        if (side_distance.x < side_distance.y) {
+            side_distance.x += delta.x;
+            map.x += step.x;
+            horizontal = false;
+        } else {
+            side_distance.y += delta.y;
+            map.y += step.y;
+            horizontal = true;
+        }
+        wall = map.in_bounds(map_dimensions_) ? cells_[map.to_index(map_dimensions_.x)] : -1;
+    }
+
+    const double distance_limit = horizontal ? side_distance.y - delta.y : side_distance.x - delta.x;
+    const double distance = distance_limit > 1e-6 ? distance_limit : 1e-6;
+    depth_[column] = static_cast<float>(distance);
+
+    const double line_height = static_cast<double>(height) / distance;
+    const double top = 0.5 * (static_cast<double>(height) - line_height);
+    const int begin_limit = static_cast<int>(std::ceil(top - 0.5));
+    const int end_limit = static_cast<int>(std::ceil(top + line_height - 0.5));
+    const int begin = begin_limit > 0 ? begin_limit : 0;
+    const int end = end_limit < height ? end_limit : height;
+
+    // Faces along x are darker, so corners stay readable
+    const float brightness = static_cast<float>(falloff(distance) * (horizontal ? 0.75 : 1.0) * static_cast<double>(ramp_.size() - 1));
+    const Texture* texture = wall > 0 and static_cast<size_t>(wall) <= textures_.size() and not textures_[wall - 1].luminance.empty() ? &textures_[wall - 1] : nullptr;
+
+    CHAR_INFO* cell = surface.data() + column;
+    int y = 0;
+    for (; y < begin; ++y, cell += width) {
+        *cell = backgrounds_[y];
+    }
+    if (texture) {
+        double wall_x = horizontal ? camera.position.x + distance * ray.x : camera.position.y + distance * ray.y;
+        wall_x -= std::floor(wall_x);
+        int texture_x = static_cast<int>(wall_x * texture->dimensions.x);
+        if ((not horizontal and ray.x > 0.0) or (horizontal and ray.y < 0.0)) {
+            texture_x = texture->dimensions.x - 1 - texture_x;
+        }
+        const double texture_step = static_cast<double>(texture->dimensions.y) / line_height;
+        double texture_y = (static_cast<double>(begin) + 0.5 - top) * texture_step;
+        const float* texels = texture->luminance.data() + texture_x;
+        for (; y < end; ++y, cell += width, texture_y += texture_step) {
+            const int row = static_cast<int>(texture_y);
+            *cell = ramp_[static_cast<size_t>(texels[static_cast<size_t>(row < texture->dimensions.y ? row : texture->dimensions.y - 1) * texture->dimensions.x] * brightness + 0.5f)];
+        }
+    } else {
+        const CHAR_INFO flat = ramp_[static_cast<size_t>(brightness + 0.5f)];
+        for (; y < end; ++y, cell += width) {
+            *cell = flat;
+        }
+    }
+    for (; y < height; ++y, cell += width) {
+        *cell = backgrounds_[y];
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Pixel.hpp"
+#include "Surface.hpp"
+#include "SpriteView.hpp"
+#include "JobSystem.hpp"
+
+
+// Pseudo-3D view of a grid of walls. Every column is cast with a DDA walk through the grid and written top to bottom
+// as one clipped span of ceiling, wall and floor; columns are cast in parallel. Walls are textured with the luminance
+// of a sprite, and everything is shaded by distance through the greyscale luminance ramp.
+class Raycaster {
+public:
+
+    static constexpr int Empty = 0;
+
+    struct Camera {
+        Coordinate<double> position;
+        // Radians, 0 looking along x
+        double angle = 0.0;
+        double field_of_view = 1.0;
+    };
+
+    Raycaster(const Coordinate<int>& map_dimensions, JobSystem&, double view_distance = 16.0);
+
+    [[nodiscard]] const Coordinate<int>& map_dimensions() const;
+
+    // Walls are numbered from 1; outside the map counts as a wall without texture
+    [[nodiscard]] int cell(const Coordinate<int>&) const;
+    void set_cell(const Coordinate<int>&, int wall);
+
+    // Untextured walls are drawn at full brightness
+    void set_texture(int wall, const SpriteView&);
+    void set_floor(double luminance);
+    void set_ceiling(double luminance);
+
+    void render(Surface&, const Camera&);
+
+    // Perpendicular distance to the wall in every column of the last render, for depth testing sprites
+    [[nodiscard]] const std::vector<float>& depth() const;
+
+private:
+
+    struct Texture {
+        Coordinate<int> dimensions;
+        std::vector<float> luminance;
+    };
+
+    JobSystem& jobs_;
+    const Coordinate<int> map_dimensions_;
+    std::vector<int> cells_;
+    std::vector<Texture> textures_;
+    double view_distance_;
+    double floor_ = 0.5, ceiling_ = 0.25;
+
+    std::array<CHAR_INFO, 256> ramp_;
+    // Shaded floor or ceiling cell of each row
+    std::vector<CHAR_INFO> backgrounds_;
+    std::vector<float> depth_;
+
+    [[nodiscard]] double falloff(double distance) const;
+    [[nodiscard]] const CHAR_INFO& shade(double luminance) const;
+    void cast(Surface&, const Camera&, int column);
+};
@@ -0,0 +1,67 @@
+#include "pch.hpp"
+
+#include "ResolutionScaler.hpp"
+
+
+ResolutionScaler::ResolutionScaler(const double budget) : budget_(budget) {
+    if (budget < 0.0) {
+        throw std::invalid_argument("Frame budget must not be negative");
+    }
+}
+
+void ResolutionScaler::set_budget(const double seconds) {
+    if (seconds < 0.0) {
+        throw std::invalid_argument("Frame budget must not be negative");
+    }
+    budget_ = seconds;
+}
+
+double ResolutionScaler::budget() const {
+    return budget_;
+}
+
+int ResolutionScaler::divisor() const {
+    return divisors_[level_];
+}
+
+
+bool ResolutionScaler::update(const double frame_time) {
+    if (budget_ == 0.0) {
+        if (level_ == 0) {
+            return false;
+        }
+        change(0);
+        return true;
+    }
+
+    average_ = average_ == 0.0 ? frame_time : average_ * 0.9 + frame_time * 0.1;
+    if (average_ > budget_) {
+        ++over_;
+        under_ = 0;
+    } else if (average_ < budget_ * headroom_) {
+        ++under_;
+        over_ = 0;
+    } else {
+        over_ = under_ = 0;
+    }
+
+    if (over_ >= frames_to_drop_ and level_ + 1 < divisors_.size()) {
+        change(level_ + 1);
+        return true;
+    }
+    if (under_ >= frames_to_rise_ and level_ > 0) {
+        change(level_ - 1);
+        return true;
+    }
+    return false;
+}
+
+
+// Private
+
+
+void ResolutionScaler::change(const size_t level) {
+    level_ = level;
+    average_ = 0.0;
+    over_ = under_ = 0;
+}
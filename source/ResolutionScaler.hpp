@@ -0,0 +1,37 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Picks the divisor of the render resolution, 1, 2 or 4 per axis, that keeps frame times within a budget. It drops a
+// level once the smoothed frame time has been over budget for a few frames, and only rises again after a long run of
+// frames well under it, so the resolution does not bounce between levels.
+class ResolutionScaler {
+public:
+
+    // A budget of zero disables scaling
+    explicit ResolutionScaler(double budget = 0.0);
+
+    void set_budget(double seconds);
+    [[nodiscard]] double budget() const;
+
+    [[nodiscard]] int divisor() const;
+
+    // Returns whether the divisor changed
+    bool update(double frame_time);
+
+private:
+
+    static constexpr std::array<int, 3> divisors_ = { 1, 2, 4 };
+    static constexpr int frames_to_drop_ = 10;
+    static constexpr int frames_to_rise_ = 120;
+    // Fraction of the budget a frame must stay under before rising, as the next level draws four times the cells
+    static constexpr double headroom_ = 0.4;
+
+    double budget_;
+    size_t level_ = 0;
+    double average_ = 0.0;
+    int over_ = 0, under_ = 0;
+
+    void change(size_t level);
+};
@@ -0,0 +1,106 @@
+#include "pch.hpp"
+
+#include "SpatialGrid.hpp"
+
+
+SpatialGrid::SpatialGrid(const Coordinate<int>& cell_dimensions) : cell_dimensions_(cell_dimensions) {
+    if (not (cell_dimensions > Coordinate<int>(0, 0))) {
+        throw std::invalid_argument("Spatial grid cell dimensions must be positive");
+    }
+}
+
+
+void SpatialGrid::clear() {
+    items_.clear();
+    entries_.clear();
+    sorted_ = true;
+}
+
+void SpatialGrid::insert(const size_t id, const Coordinate<int>& position, const Coordinate<int>& dimensions) {
+    const auto item = static_cast<uint32_t>(items_.size());
+    items_.push_back({ id, position, dimensions });
+    const Coordinate<int> first = cell(position);
+    const Coordinate<int> last = cell(position + dimensions - Coordinate<int>(1, 1));
+    Coordinate<int> current;
+    for (current.y = first.y; current.y <= last.y; ++current.y) {
+        for (current.x = first.x; current.x <= last.x; ++current.x) {
+            entries_.push_back({ key(current), item });
+        }
+    }
+    sorted_ = false;
+}
+
+
+void SpatialGrid::query(const Coordinate<int>& position, const Coordinate<int>& dimensions, std::vector<size_t>& results) {
+    sort();
+    if (stamps_.size() < items_.size()) {
+        stamps_.resize(items_.size(), 0);
+    }
+    if (++stamp_ == 0) {
+        std::fill(stamps_.begin(), stamps_.end(), 0);
+        stamp_ = 1;
+    }
+
+    const Item area = { 0, position, dimensions };
+    const Coordinate<int> first = cell(position);
+    const Coordinate<int> last = cell(position + dimensions - Coordinate<int>(1, 1));
+    Coordinate<int> current;
+    for (current.y = first.y; current.y <= last.y; ++current.y) {
+        for (current.x = first.x; current.x <= last.x; ++current.x) {
+            const uint64_t cell_key = key(current);
+            auto entry = std::lower_bound(entries_.begin(), entries_.end(), Entry{ cell_key, 0 });
+            for (; entry != entries_.end() and entry->cell == cell_key; ++entry) {
+                if (stamps_[entry->item] != stamp_ and intersects(items_[entry->item], area)) {
+                    stamps_[entry->item] = stamp_;
+                    results.push_back(items_[entry->item].id);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::pairs(std::vector<std::pair<size_t, size_t>>& results) {
+    sort();
+    for (auto begin = entries_.begin(); begin != entries_.end();) {
+        auto end = begin;
+        while (end != entries_.end() and end->cell == begin->cell) {
+            ++end;
+        }
+        for (auto lhs = begin; lhs != end; ++lhs) {
+            for (auto rhs = lhs + 1; rhs != end; ++rhs) {
+                const Item& a = items_[lhs->item];
+                const Item& b = items_[rhs->item];
+                if (not intersects(a, b)) {
+                    continue;
+                }
+                // Pairs sharing several cells are reported only from the cell holding the top left of their overlap
+                const Coordinate<int> overlap = { a.position.x > b.position.x ? a.position.x : b.position.x, a.position.y > b.position.y ? a.position.y : b.position.y };
+                if (key(cell(overlap)) == begin->cell) {
+                    results.emplace_back(a.id, b.id);
+                }
+            }
+        }
+        begin = end;
+    }
+}
+
+
+Coordinate<int> SpatialGrid::cell(const Coordinate<int>& position) const {
+    auto floor_divide = [](const int a, const int b) { return a / b - (a % b != 0 and (a < 0) != (b < 0)); };
+    return { floor_divide(position.x, cell_dimensions_.x), floor_divide(position.y, cell_dimensions_.y) };
+}
+
+uint64_t SpatialGrid::key(const Coordinate<int>& cell) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(cell.y)) << 32 | static_cast<uint32_t>(cell.x);
+}
+
+bool SpatialGrid::intersects(const Item& lhs, const Item& rhs) {
+    return lhs.position < rhs.position + rhs.dimensions and rhs.position < lhs.position + lhs.dimensions;
+}
+
+void SpatialGrid::sort() {
+    if (not sorted_) {
+        std::sort(entries_.begin(), entries_.end());
+        sorted_ = true;
+    }
+}
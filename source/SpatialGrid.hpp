@@ -0,0 +1,49 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+
+
+// Uniform grid broad phase over axis-aligned boxes. Meant to be cleared and refilled every frame; storage is reused,
+// so steady state insertion and queries do not allocate.
+class SpatialGrid {
+public:
+
+    explicit SpatialGrid(const Coordinate<int>& cell_dimensions = { 16, 16 });
+
+    void clear();
+    void insert(size_t id, const Coordinate<int>& position, const Coordinate<int>& dimensions);
+
+    // Appends the id of every box overlapping the area, each once. Queries sort the grid and stamp the boxes they
+    // visit, so they are not const and a grid must not be queried from several threads at once.
+    void query(const Coordinate<int>& position, const Coordinate<int>& dimensions, std::vector<size_t>& results);
+
+    // Appends every pair of overlapping boxes, each once
+    void pairs(std::vector<std::pair<size_t, size_t>>& results);
+
+private:
+
+    struct Item {
+        size_t id;
+        Coordinate<int> position, dimensions;
+    };
+
+    struct Entry {
+        uint64_t cell;
+        uint32_t item;
+        friend bool operator<(const Entry& lhs, const Entry& rhs) { return lhs.cell < rhs.cell or (lhs.cell == rhs.cell and lhs.item < rhs.item); }
+    };
+
+    const Coordinate<int> cell_dimensions_;
+    std::vector<Item> items_;
+    std::vector<Entry> entries_;
+    bool sorted_ = true;
+    std::vector<uint32_t> stamps_;
+    uint32_t stamp_ = 0;
+
+    Coordinate<int> cell(const Coordinate<int>& position) const;
+    static uint64_t key(const Coordinate<int>& cell);
+    static bool intersects(const Item& lhs, const Item& rhs);
+    void sort();
+};
@@ -3,30 +3,18 @@
 #include "Sprite.hpp"
 
 
-Sprite::Sprite() : dimensions_({ 0, 0 }) {}
+Sprite::Sprite() : Surface() {}
 
-Sprite::Sprite(const Coordinate<int>& dimensions) : dimensions_(dimensions), texture_(dimensions.x* dimensions.y) {}
+Sprite::Sprite(const Coordinate<int>& dimensions) : Surface(dimensions) {}
 
 Sprite::Sprite(const std::string& filename) {
     load(filename);
 }
 
 
-const Coordinate<int>& Sprite::dimensions() const {
-    return dimensions_;
-}
-
-int Sprite::width() const {
-    return dimensions_.x;
-}
-
-int Sprite::height() const {
-    return dimensions_.y;
-}
-
 Pixel Sprite::pixel(const Coordinate<int>& coordinate) const {
     if (coordinate.in_bounds(dimensions_)) {
-        return texture_[coordinate.to_index(dimensions_.x)];
+        return Pixel(cells_[coordinate.to_index(dimensions_.x)]);
     } else {
         return { Pixel::Colour::White, Pixel::Shade::Empty };
     }
@@ -38,10 +26,7 @@ void Sprite::save(const std::string& file_name) const {
     if (not file_stream.is_open()) {
         throw std::runtime_error("Unable to open file '" + file_name + "'");
     }
-    file_stream << dimensions_;
-    for (const Pixel& pixel : texture_) {
-        file_stream << ' ' << pixel;
-    }
+    file_stream << *this;
     file_stream.close();
 }
 
@@ -50,10 +35,37 @@ void Sprite::load(const std::string& file_name) {
     if (not file_stream.is_open()) {
         throw std::runtime_error("Unable to open file '" + file_name + "'");
     }
-    file_stream >> dimensions_;
-    texture_ = std::vector<Pixel>(dimensions_.x * dimensions_.y);
-    for (Pixel& pixel : texture_) {
-        file_stream >> pixel;
+    if (not (file_stream >> *this)) {
+        throw std::runtime_error("Sprite file '" + file_name + "' is truncated or malformed");
     }
     file_stream.close();
+}
+
+
+std::ostream& operator<<(std::ostream& stream, const Sprite& sprite) {
+    stream << sprite.dimensions_;
+    for (const CHAR_INFO& cell : sprite.cells_) {
+        stream << ' ' << Pixel(cell);
+    }
+    return stream;
+}
+
+std::istream& operator>>(std::istream& stream, Sprite& sprite) {
+    Coordinate<int> dimensions;
+    if (not (stream >> dimensions)) {
+        return stream;
+    }
+    if (dimensions.x < 0 or dimensions.y < 0) {
+        stream.setstate(std::ios::failbit);
+        return stream;
+    }
+    sprite.resize(dimensions);
+    Pixel pixel;
+    for (CHAR_INFO& cell : sprite.cells_) {
+        if (not (stream >> pixel)) {
+            return stream;
+        }
+        cell = pixel.char_info();
+    }
+    return stream;
 }
\ No newline at end of file
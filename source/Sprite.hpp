@@ -4,25 +4,21 @@
 
 #include "Coordinate.hpp"
 #include "Pixel.hpp"
+#include "Surface.hpp"
 
 
-class Sprite {
+class Sprite : public Surface {
 public:
 
     Sprite();
     Sprite(const Coordinate<int>& dimensions);
     Sprite(const std::string& filename);
 
-    const Coordinate<int>& dimensions() const;
-    int width() const;
-    int height() const;
     Pixel pixel(const Coordinate<int>& coordinate) const;
 
     void save(const std::string& filename) const;
     void load(const std::string& filename);
 
-private:
-
-    Coordinate<int> dimensions_;
-    std::vector<Pixel> texture_;
+    friend std::ostream& operator<<(std::ostream&, const Sprite&);
+    friend std::istream& operator>>(std::istream&, Sprite&);
 };
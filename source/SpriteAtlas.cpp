@@ -0,0 +1,135 @@
+#include "pch.hpp"
+
+#include "SpriteAtlas.hpp"
+
+
+SpriteAtlas::SpriteAtlas() = default;
+
+SpriteAtlas::SpriteAtlas(const std::string& filename) {
+    load(filename);
+}
+
+SpriteAtlas::SpriteAtlas(const Sprite& sheet, const Coordinate<int>& frame_dimensions) : texture_(sheet) {
+    if (not (frame_dimensions > Coordinate<int>(0, 0))) {
+        throw std::invalid_argument("Atlas frame dimensions must be positive");
+    }
+    Coordinate<int> position;
+    for (position.y = 0; position.y + frame_dimensions.y <= sheet.height(); position.y += frame_dimensions.y) {
+        for (position.x = 0; position.x + frame_dimensions.x <= sheet.width(); position.x += frame_dimensions.x) {
+            frames_.push_back({ position, frame_dimensions });
+        }
+    }
+}
+
+SpriteAtlas::SpriteAtlas(const std::vector<const Sprite*>& sprites, int maximum_width) {
+    if (maximum_width <= 0) {
+        int area = 0, widest = 0;
+        for (const Sprite* sprite : sprites) {
+            area += sprite->width() * sprite->height();
+            widest = sprite->width() > widest ? sprite->width() : widest;
+        }
+        maximum_width = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area))));
+        maximum_width = widest > maximum_width ? widest : maximum_width;
+    }
+
+    std::vector<size_t> order(sprites.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return sprites[a]->height() > sprites[b]->height(); });
+
+    frames_.resize(sprites.size());
+    Coordinate<int> cursor, dimensions;
+    int shelf_height = 0;
+    for (const size_t index : order) {
+        const Sprite& sprite = *sprites[index];
+        if (sprite.width() > maximum_width) {
+            throw std::invalid_argument("Sprite is wider than the atlas");
+        }
+        if (cursor.x + sprite.width() > maximum_width) {
+            cursor = { 0, cursor.y + shelf_height };
+            shelf_height = 0;
+        }
+        frames_[index] = { cursor, sprite.dimensions() };
+        cursor.x += sprite.width();
+        shelf_height = sprite.height() > shelf_height ? sprite.height() : shelf_height;
+        dimensions = { cursor.x > dimensions.x ? cursor.x : dimensions.x, cursor.y + shelf_height };
+    }
+
+    texture_ = Sprite(dimensions);
+    texture_.clear(Pixel::Shade::Empty);
+    for (size_t index = 0; index < sprites.size(); ++index) {
+        texture_.blit(frames_[index].position, *sprites[index]);
+    }
+}
+
+
+const Sprite& SpriteAtlas::texture() const {
+    return texture_;
+}
+
+size_t SpriteAtlas::size() const {
+    return frames_.size();
+}
+
+const SpriteAtlas::Frame& SpriteAtlas::frame(const size_t index) const {
+    return frames_.at(index);
+}
+
+SpriteView SpriteAtlas::view(const size_t index) const {
+    const Frame& frame = frames_.at(index);
+    return SpriteView(texture_, frame.position, frame.dimensions);
+}
+
+std::vector<SpriteView> SpriteAtlas::views(const size_t first, const size_t count) const {
+    std::vector<SpriteView> views;
+    views.reserve(count);
+    for (size_t index = first; index < first + count; ++index) {
+        views.push_back(view(index));
+    }
+    return views;
+}
+
+
+void SpriteAtlas::save(const std::string& file_name) const {
+    std::ofstream file_stream(file_name, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (not file_stream.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    file_stream << frames_.size();
+    for (const auto& [position, dimensions] : frames_) {
+        file_stream << ' ' << position << ' ' << dimensions;
+    }
+    file_stream << ' ' << texture_;
+    file_stream.close();
+}
+
+void SpriteAtlas::load(const std::string& file_name) {
+    std::ifstream file_stream(file_name, std::ios::in | std::ios::binary);
+    if (not file_stream.is_open()) {
+        throw std::runtime_error("Unable to open file '" + file_name + "'");
+    }
+    // Every frame takes at least eight characters, four numbers each followed by a space, which bounds the frame count
+    // before anything is allocated for it
+    size_t size = 0;
+    if (not (file_stream >> size) or size > std::filesystem::file_size(file_name) / 8) {
+        throw std::runtime_error("Atlas '" + file_name + "' is truncated or malformed");
+    }
+    std::vector<Frame> frames(size);
+    for (auto& [position, dimensions] : frames) {
+        if (not (file_stream >> position >> dimensions) or not (position >= Coordinate<int>(0, 0)) or not (dimensions >= Coordinate<int>(0, 0))) {
+            throw std::runtime_error("Atlas '" + file_name + "' is truncated or malformed");
+        }
+    }
+    Sprite texture;
+    if (not (file_stream >> texture)) {
+        throw std::runtime_error("Atlas '" + file_name + "' is truncated or malformed");
+    }
+    file_stream.close();
+    // Compared against the space left past the position, as position + dimensions could overflow
+    for (const auto& [position, dimensions] : frames) {
+        if (not (position <= texture.dimensions() and dimensions <= texture.dimensions() - position)) {
+            throw std::runtime_error("Atlas '" + file_name + "' has a frame outside its texture");
+        }
+    }
+    frames_ = std::move(frames);
+    texture_ = std::move(texture);
+}
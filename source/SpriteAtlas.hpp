@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Sprite.hpp"
+#include "SpriteView.hpp"
+
+
+// Many sprites packed into one texture, handed out as views into it
+class SpriteAtlas {
+public:
+
+    struct Frame {
+        Coordinate<int> position, dimensions;
+    };
+
+    SpriteAtlas();
+    SpriteAtlas(const std::string& filename);
+    // Slices an existing sprite sheet into a grid of equally sized frames, row by row
+    SpriteAtlas(const Sprite& sheet, const Coordinate<int>& frame_dimensions);
+    // Packs the sprites into rows, tallest first, and keeps their order for indexing
+    SpriteAtlas(const std::vector<const Sprite*>& sprites, int maximum_width = 0);
+
+    [[nodiscard]] const Sprite& texture() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] const Frame& frame(size_t index) const;
+
+    [[nodiscard]] SpriteView view(size_t index) const;
+    [[nodiscard]] std::vector<SpriteView> views(size_t first, size_t count) const;
+
+    void save(const std::string& filename) const;
+    void load(const std::string& filename);
+
+private:
+
+    Sprite texture_;
+    std::vector<Frame> frames_;
+};
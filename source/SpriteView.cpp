@@ -0,0 +1,41 @@
+#include "pch.hpp"
+
+#include "SpriteView.hpp"
+
+
+SpriteView::SpriteView() : origin_(nullptr), stride_(0), dimensions_({ 0, 0 }) {}
+
+SpriteView::SpriteView(const Surface& surface) : origin_(surface.data()), stride_(surface.width()), dimensions_(surface.dimensions()) {}
+
+SpriteView::SpriteView(const Surface& surface, const Coordinate<int>& position, const Coordinate<int>& dimensions)
+    : origin_(nullptr), stride_(surface.width()), dimensions_(dimensions) {
+    if (not (position >= Coordinate<int>(0, 0) and dimensions >= Coordinate<int>(0, 0) and position + dimensions <= surface.dimensions())) {
+        throw std::out_of_range("Sprite view does not fit within its surface");
+    }
+    origin_ = surface.data() + position.to_index(surface.width());
+}
+
+
+const Coordinate<int>& SpriteView::dimensions() const {
+    return dimensions_;
+}
+
+int SpriteView::width() const {
+    return dimensions_.x;
+}
+
+int SpriteView::height() const {
+    return dimensions_.y;
+}
+
+const CHAR_INFO* SpriteView::row(const int y) const {
+    return origin_ + static_cast<size_t>(y) * stride_;
+}
+
+Pixel SpriteView::pixel(const Coordinate<int>& coordinate) const {
+    if (coordinate.in_bounds(dimensions_)) {
+        return Pixel(row(coordinate.y)[coordinate.x]);
+    } else {
+        return { Pixel::Colour::White, Pixel::Shade::Empty };
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Pixel.hpp"
+#include "Surface.hpp"
+
+
+// Non-owning window onto a rectangle of a surface, e.g. one frame of an atlas. Stays valid while the surface's cells
+// are neither resized nor destroyed; moving the surface is fine.
+class SpriteView {
+public:
+
+    SpriteView();
+    SpriteView(const Surface&);
+    SpriteView(const Surface&, const Coordinate<int>& position, const Coordinate<int>& dimensions);
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] int width() const;
+    [[nodiscard]] int height() const;
+
+    [[nodiscard]] const CHAR_INFO* row(int y) const;
+    [[nodiscard]] Pixel pixel(const Coordinate<int>& coordinate) const;
+
+private:
+
+    const CHAR_INFO* origin_;
+    int stride_;
+    Coordinate<int> dimensions_;
+};
@@ -0,0 +1,500 @@
+#include "pch.hpp"
+
+#include "Surface.hpp"
+#include "Sprite.hpp"
+#include "SpriteView.hpp"
+#include "Text.hpp"
+
+
+Surface::Surface() : dimensions_({ 0, 0 }) {}
+
+Surface::Surface(const Coordinate<int>& dimensions, const Pixel& pixel) : dimensions_(dimensions), cells_(dimensions.x * dimensions.y, pixel.char_info()) {}
+
+
+void Surface::resize(const Coordinate<int>& dimensions, const Pixel& pixel) {
+    dimensions_ = dimensions;
+    cells_.assign(static_cast<size_t>(dimensions.x) * dimensions.y, pixel.char_info());
+}
+
+bool Surface::clip(const Coordinate<int>& coordinate, const Coordinate<int>& dimensions, Coordinate<int>& begin, Coordinate<int>& end) const {
+    begin = { coordinate.x < 0 ? -coordinate.x : 0, coordinate.y < 0 ? -coordinate.y : 0 };
+    end = {
+        coordinate.x + dimensions.x > dimensions_.x ? dimensions_.x - coordinate.x : dimensions.x,
+        coordinate.y + dimensions.y > dimensions_.y ? dimensions_.y - coordinate.y : dimensions.y,
+    };
+    return begin.x < end.x and begin.y < end.y;
+}
+
+
+void Surface::draw_line_of_text(const Coordinate<int>& coordinate, const std::wstring_view text, const WORD attributes) {
+    Coordinate<int> begin, end;
+    if (not clip(coordinate, { static_cast<int>(text.size()), 1 }, begin, end)) {
+        return;
+    }
+    CHAR_INFO* const destination = row(coordinate.y) + coordinate.x + begin.x;
+    for (int x = begin.x; x < end.x; ++x) {
+        destination[x - begin.x].Char.UnicodeChar = text[static_cast<size_t>(x)];
+        destination[x - begin.x].Attributes = attributes;
+    }
+}
+
+
+// Getters
+
+
+const Coordinate<int>& Surface::dimensions() const {
+    return dimensions_;
+}
+
+int Surface::width() const {
+    return dimensions_.x;
+}
+
+int Surface::height() const {
+    return dimensions_.y;
+}
+
+CHAR_INFO* Surface::data() {
+    return cells_.data();
+}
+
+const CHAR_INFO* Surface::data() const {
+    return cells_.data();
+}
+
+CHAR_INFO* Surface::row(const int y) {
+    return cells_.data() + static_cast<size_t>(y) * dimensions_.x;
+}
+
+const CHAR_INFO* Surface::row(const int y) const {
+    return cells_.data() + static_cast<size_t>(y) * dimensions_.x;
+}
+
+
+
+// Drawing functions
+
+
+void Surface::clear(const Pixel& pixel) {
+    std::fill(cells_.begin(), cells_.end(), pixel.char_info());
+}
+
+void Surface::draw_character(const Coordinate<int>& coordinate, const WCHAR character, const Pixel::Colour colour) {
+    if (coordinate.in_bounds(dimensions_)) {
+        const size_t index = coordinate.to_index(dimensions_.x);
+        cells_[index].Char.UnicodeChar = character;
+        cells_[index].Attributes = static_cast<WORD>(colour);
+    }
+}
+
+template <typename Operation>
+void Surface::draw_pixel(const Coordinate<int>& coordinate, const Pixel& pixel) {
+    if (coordinate.in_bounds(dimensions_)) {
+        Operation::apply(cells_[coordinate.to_index(dimensions_.x)], pixel.char_info());
+    }
+}
+
+template <typename Operation>
+void Surface::draw_sprite(const Coordinate<int>& coordinate, const Sprite& sprite, const int scale) {
+    draw_sprite<Operation>(coordinate, SpriteView(sprite), scale);
+}
+
+template <typename Operation>
+void Surface::draw_sprite(const Coordinate<int>& coordinate, const SpriteView& sprite, const int scale) {
+    Coordinate<int> begin, end;
+    if (not clip(coordinate, sprite.dimensions() * scale, begin, end)) {
+        return;
+    }
+    for (int y = begin.y; y < end.y; ++y) {
+        const CHAR_INFO* source = sprite.row(y / scale);
+        CHAR_INFO* destination = row(coordinate.y + y) + coordinate.x;
+        if (scale == 1) {
+            for (int x = begin.x; x < end.x; ++x) {
+                Operation::apply(destination[x], source[x]);
+            }
+        } else {
+            for (int x = begin.x; x < end.x; ++x) {
+                Operation::apply(destination[x], source[x / scale]);
+            }
+        }
+    }
+}
+
+void Surface::draw_string(const Coordinate<int>& coordinate, const std::wstring_view string, const Pixel::Colour colour) {
+    Coordinate<int> line = coordinate;
+    for (size_t first = 0; first <= string.size(); ++line.y) {
+        const size_t last = string.find(L'\n', first);
+        const size_t length = last == std::wstring_view::npos ? string.size() - first : last - first;
+        draw_line_of_text(line, string.substr(first, length), static_cast<WORD>(colour));
+        first += length + 1;
+    }
+}
+
+void Surface::draw_string(const Coordinate<int>& coordinate, const std::string_view string, const Pixel::Colour colour) {
+    // Keeps its capacity, so strings drawn every frame are decoded without allocating
+    thread_local std::wstring glyphs;
+    glyphs.clear();
+    Text::decode(string, glyphs);
+    draw_string(coordinate, std::wstring_view(glyphs), colour);
+}
+
+void Surface::draw_string(const Coordinate<int>& coordinate, const Text& text, const Pixel::Colour colour) {
+    draw_string(coordinate, text.glyphs(), colour);
+}
+
+void Surface::draw_line(const Coordinate<int>& start, const Coordinate<int>& end, const Pixel& pixel) {
+    Coordinate<int> current = start;
+    Coordinate<int> delta = end - start;
+    const Coordinate<int> step = { (delta.x > 0) - (delta.x < 0), (delta.y > 0) - (delta.y < 0) };
+    auto abs = [](int x) { return x > 0 ? x : -x; };
+    delta = { abs(delta.x), abs(delta.y) };
+
+    if (delta.x > delta.y) {
+        int error = delta.x / 2;
+        while (current.x != end.x) {
+            draw_pixel(current, pixel);
+            error -= delta.y;
+            if (error < 0) {
+                current.y += step.y;
+                error += delta.x;
+            }
+            current.x += step.x;
+        }
+    } else {
+        int error = delta.y / 2;
+        while (current.y != end.y) {
+            draw_pixel(current, pixel);
+            error -= delta.x;
+            if (error < 0) {
+                current.x += step.x;
+                error += delta.y;
+            }
+            current.y += step.y;
+        }
+    }
+}
+
+void Surface::draw_triangle(const std::array<Coordinate<int>, 3>& vertices, const Pixel& pixel) {
+    draw_line(vertices[0], vertices[1], pixel);
+    draw_line(vertices[1], vertices[2], pixel);
+    draw_line(vertices[2], vertices[0], pixel);
+}
+
+void Surface::draw_filled_triangle(const std::array<Coordinate<int>, 3>& vertices, const Pixel& pixel) {
+    // auto swap = [](Coordinate<int>& a, Coordinate<int>& b) {
+    //     const Coordinate<int> temp = a;
+    // 	a = b;
+    // 	b = temp;
+    // };
+    // auto draw_scan_line = [&](const Coordinate<int>& start, const Coordinate<int>& end) {
+    //     for (int x = start.x; x <= end.x; ++x) {
+    //         draw_pixel(Coordinate<int>(x, start.y), pixel);
+    //     }
+    // };
+
+    // std::array<Coordinate<int>, 3> sorted_vertices = vertices;
+    // std::sort(sorted_vertices.begin(), sorted_vertices.end(), [](const Coordinate<int>& a, const Coordinate<int>& b) { return a.y < b.y; }
+
+    int x1 = vertices[0].x; int y1 = vertices[0].y;
+    int x2 = vertices[1].x; int y2 = vertices[1].y;
+    int x3 = vertices[2].x; int y3 = vertices[2].y;
+
+    auto SWAP = [](int& x, int& y) { int t = x; x = y; y = t; };
+    auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) draw_pixel({ i, ny }, pixel); };
+
+    int t1x, t2x, y, minx, maxx, t1xp, t2xp;
+    bool changed1 = false;
+    bool changed2 = false;
+    int signx1, signx2, dx1, dy1, dx2, dy2;
+    int e1, e2;
+    // Sort vertices
+    if (y1 > y2) { SWAP(y1, y2); SWAP(x1, x2); }
+    if (y1 > y3) { SWAP(y1, y3); SWAP(x1, x3); }
+    if (y2 > y3) { SWAP(y2, y3); SWAP(x2, x3); }
+
+    t1x = t2x = x1; y = y1;   // Starting points
+    dx1 = (int)(x2 - x1); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; } else signx1 = 1;
+    dy1 = (int)(y2 - y1);
+
+    dx2 = (int)(x3 - x1); if (dx2 < 0) { dx2 = -dx2; signx2 = -1; } else signx2 = 1;
+    dy2 = (int)(y3 - y1);
+
+    if (dy1 > dx1) {   // swap values
+        SWAP(dx1, dy1);
+        changed1 = true;
+    }
+    if (dy2 > dx2) {   // swap values
+        SWAP(dy2, dx2);
+        changed2 = true;
+    }
+
+    e2 = (int)(dx2 >> 1);
+    // Flat top, just process the second half
+    if (y1 == y2) goto next;
+    e1 = (int)(dx1 >> 1);
+
+    for (int i = 0; i < dx1;) {
+        t1xp = 0; t2xp = 0;
+        if (t1x < t2x) { minx = t1x; maxx = t2x; } else { minx = t2x; maxx = t1x; }
+        // process first line until y value is about to change
+        while (i < dx1) {
+            ++i;
+            e1 += dy1;
+            while (e1 >= dx1) {
+                e1 -= dx1;
+                if (changed1) t1xp = signx1;
+                else          goto next1;
+            }
+            if (changed1) break;
+            else t1x += signx1;
+        }
+        // Move line
+    next1:
+        // process second line until y value is about to change
+        while (true) {
+            e2 += dy2;
+            while (e2 >= dx2) {
+                e2 -= dx2;
+                if (changed2) t2xp = signx2;
+                else          goto next2;
+            }
+            if (changed2)     break;
+            else              t2x += signx2;
+        }
+    next2:
+        if (minx > t1x) minx = t1x; if (minx > t2x) minx = t2x;
+        if (maxx < t1x) maxx = t1x; if (maxx < t2x) maxx = t2x;
+        drawline(minx, maxx, y);    // Draw line from min to max points found on the y
+                                     // Now increase y
+        if (!changed1) t1x += signx1;
+        t1x += t1xp;
+        if (!changed2) t2x += signx2;
+        t2x += t2xp;
+        y += 1;
+        if (y == y2) break;
+
+    }
+next:
+    // Second half
+    dx1 = (int)(x3 - x2); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; } else signx1 = 1;
+    dy1 = (int)(y3 - y2);
+    t1x = x2;
+
+    if (dy1 > dx1) {   // swap values
+        SWAP(dy1, dx1);
+        changed1 = true;
+    } else changed1 = false;
+
+    e1 = (int)(dx1 >> 1);
+
+    for (int i = 0; i <= dx1; ++i) {
+        t1xp = 0; t2xp = 0;
+        if (t1x < t2x) { minx = t1x; maxx = t2x; } else { minx = t2x; maxx = t1x; }
+        // process first line until y value is about to change
+        while (i < dx1) {
+            e1 += dy1;
+            while (e1 >= dx1) {
+                e1 -= dx1;
+                if (changed1) { t1xp = signx1; break; } else          goto next3;
+            }
+            if (changed1) break;
+            else   	   	  t1x += signx1;
+            if (i < dx1) ++i;
+        }
+    next3:
+        // process second line until y value is about to change
+        while (t2x != x3) {
+            e2 += dy2;
+            while (e2 >= dx2) {
+                e2 -= dx2;
+                if (changed2) t2xp = signx2;
+                else          goto next4;
+            }
+            if (changed2)     break;
+            else              t2x += signx2;
+        }
+    next4:
+
+        if (minx > t1x) minx = t1x; if (minx > t2x) minx = t2x;
+        if (maxx < t1x) maxx = t1x; if (maxx < t2x) maxx = t2x;
+        drawline(minx, maxx, y);
+        if (!changed1) t1x += signx1;
+        t1x += t1xp;
+        if (!changed2) t2x += signx2;
+        t2x += t2xp;
+        y += 1;
+        if (y > y3) return;
+    }
+}
+
+void Surface::draw_circle(const Coordinate<int>& centre, const int radius, const Pixel& pixel) {
+    Coordinate<int> current = { 0, radius };
+    int p = 1 - radius;
+    while (current.x <= current.y) {
+        draw_pixel(centre + current, pixel);
+        draw_pixel(centre - current, pixel);
+        draw_pixel(centre + Coordinate<int>(current.y, current.x), pixel);
+        draw_pixel(centre - Coordinate<int>(current.y, current.x), pixel);
+        draw_pixel(centre + Coordinate<int>(-current.x, current.y), pixel);
+        draw_pixel(centre - Coordinate<int>(-current.x, current.y), pixel);
+        draw_pixel(centre + Coordinate<int>(current.x, -current.y), pixel);
+        draw_pixel(centre - Coordinate<int>(current.x, -current.y), pixel);
+        if (p < 0) {
+            p += 2 * current.x + 3;
+        } else {
+            p += 2 * (current.x - current.y) + 5;
+            --current.y;
+        }
+        ++current.x;
+    }
+}
+
+void Surface::draw_filled_circle(const Coordinate<int>& centre, const int radius, const Pixel& pixel) {
+    Coordinate<int> current = { 0, radius };
+    int p = 1 - radius;
+    while (current.x <= current.y) {
+        draw_line(centre + Coordinate<int>(-current.y, current.x), centre + Coordinate<int>(current.y, current.x), pixel);
+        draw_line(centre + Coordinate<int>(-current.x, current.y), centre + current, pixel);
+        draw_line(centre - current, centre + Coordinate<int>(current.x, -current.y), pixel);
+        draw_line(centre + Coordinate<int>(-current.y, -current.x), centre + Coordinate<int>(current.y, -current.x), pixel);
+        if (p < 0) {
+            p += 2 * current.x + 3;
+        } else {
+            p += 2 * (current.x - current.y) + 5;
+            --current.y;
+        }
+        ++current.x;
+    }
+}
+
+void Surface::draw_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel& pixel) {
+    Coordinate<int> current;
+    for (current.x = top_left.x; current.x <= bottom_right.x; ++current.x) {
+        for (current.y = top_left.y; current.y <= bottom_right.y; ++current.y) {
+            if (current.x == top_left.x or current.x == bottom_right.x or
+                current.y == top_left.y or current.y == bottom_right.y) {
+                draw_pixel(current, pixel);
+            }
+        }
+    }
+}
+
+template <typename Operation>
+void Surface::draw_filled_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel& pixel) {
+    Coordinate<int> begin, end;
+    if (not clip(top_left, bottom_right - top_left + Coordinate<int>(1, 1), begin, end)) {
+        return;
+    }
+    const CHAR_INFO cell = pixel.char_info();
+    for (int y = begin.y; y < end.y; ++y) {
+        CHAR_INFO* destination = row(top_left.y + y) + top_left.x;
+        if constexpr (std::is_same_v<Operation, Blend::Opaque>) {
+            std::fill(destination + begin.x, destination + end.x, cell);
+        } else {
+            for (int x = begin.x; x < end.x; ++x) {
+                Operation::apply(destination[x], cell);
+            }
+        }
+    }
+}
+
+
+void Surface::blit(const Coordinate<int>& coordinate, const SpriteView& source) {
+    Coordinate<int> begin, end;
+    if (not clip(coordinate, source.dimensions(), begin, end)) {
+        return;
+    }
+    const size_t length = static_cast<size_t>(end.x - begin.x);
+    for (int y = begin.y; y < end.y; ++y) {
+        std::copy_n(source.row(y) + begin.x, length, row(coordinate.y + y) + coordinate.x + begin.x);
+    }
+}
+
+void Surface::copy(const Coordinate<int>& source, const Coordinate<int>& dimensions, const Coordinate<int>& destination) {
+    Coordinate<int> begin, end, destination_begin, destination_end;
+    if (not clip(source, dimensions, begin, end) or not clip(destination, dimensions, destination_begin, destination_end)) {
+        return;
+    }
+    begin = { begin.x > destination_begin.x ? begin.x : destination_begin.x, begin.y > destination_begin.y ? begin.y : destination_begin.y };
+    end = { end.x < destination_end.x ? end.x : destination_end.x, end.y < destination_end.y ? end.y : destination_end.y };
+    if (not (begin < end)) {
+        return;
+    }
+    const size_t length = static_cast<size_t>(end.x - begin.x) * sizeof(CHAR_INFO);
+    auto move_row = [&](const int y) {
+        std::memmove(row(destination.y + y) + destination.x + begin.x, row(source.y + y) + source.x + begin.x, length);
+    };
+    if (destination.y > source.y) {
+        for (int y = end.y - 1; y >= begin.y; --y) {
+            move_row(y);
+        }
+    } else {
+        for (int y = begin.y; y < end.y; ++y) {
+            move_row(y);
+        }
+    }
+}
+
+void Surface::scroll(const Coordinate<int>& position, const Coordinate<int>& dimensions, const Coordinate<int>& delta, const Pixel& pixel) {
+    Coordinate<int> begin, end;
+    if (not clip(position, dimensions, begin, end)) {
+        return;
+    }
+    const Coordinate<int> top_left = position + begin;
+    const Coordinate<int> size = end - begin;
+    const Coordinate<int> distance = { delta.x < 0 ? -delta.x : delta.x, delta.y < 0 ? -delta.y : delta.y };
+    const Coordinate<int> bottom_right = top_left + size - Coordinate<int>(1, 1);
+    if (not (distance < size)) {
+        draw_filled_rectangle(top_left, bottom_right, pixel);
+        return;
+    }
+
+    copy(
+        top_left + Coordinate<int>(delta.x < 0 ? distance.x : 0, delta.y < 0 ? distance.y : 0),
+        size - distance,
+        top_left + Coordinate<int>(delta.x > 0 ? distance.x : 0, delta.y > 0 ? distance.y : 0)
+    );
+
+    if (delta.y > 0) {
+        draw_filled_rectangle(top_left, { bottom_right.x, top_left.y + delta.y - 1 }, pixel);
+    } else if (delta.y < 0) {
+        draw_filled_rectangle({ top_left.x, bottom_right.y + delta.y + 1 }, bottom_right, pixel);
+    }
+    if (delta.x > 0) {
+        draw_filled_rectangle(top_left, { top_left.x + delta.x - 1, bottom_right.y }, pixel);
+    } else if (delta.x < 0) {
+        draw_filled_rectangle({ bottom_right.x + delta.x + 1, top_left.y }, bottom_right, pixel);
+    }
+}
+
+
+// Blend operations
+
+
+template void Surface::draw_pixel<Blend::Opaque>(const Coordinate<int>&, const Pixel&);
+template void Surface::draw_pixel<Blend::Transparent>(const Coordinate<int>&, const Pixel&);
+template void Surface::draw_pixel<Blend::ColourOnly>(const Coordinate<int>&, const Pixel&);
+template void Surface::draw_pixel<Blend::GlyphOnly>(const Coordinate<int>&, const Pixel&);
+template void Surface::draw_pixel<Blend::Xor>(const Coordinate<int>&, const Pixel&);
+template void Surface::draw_pixel<Blend::Additive>(const Coordinate<int>&, const Pixel&);
+
+template void Surface::draw_sprite<Blend::Opaque>(const Coordinate<int>&, const Sprite&, int);
+template void Surface::draw_sprite<Blend::Transparent>(const Coordinate<int>&, const Sprite&, int);
+template void Surface::draw_sprite<Blend::ColourOnly>(const Coordinate<int>&, const Sprite&, int);
+template void Surface::draw_sprite<Blend::GlyphOnly>(const Coordinate<int>&, const Sprite&, int);
+template void Surface::draw_sprite<Blend::Xor>(const Coordinate<int>&, const Sprite&, int);
+template void Surface::draw_sprite<Blend::Additive>(const Coordinate<int>&, const Sprite&, int);
+
+template void Surface::draw_sprite<Blend::Opaque>(const Coordinate<int>&, const SpriteView&, int);
+template void Surface::draw_sprite<Blend::Transparent>(const Coordinate<int>&, const SpriteView&, int);
+template void Surface::draw_sprite<Blend::ColourOnly>(const Coordinate<int>&, const SpriteView&, int);
+template void Surface::draw_sprite<Blend::GlyphOnly>(const Coordinate<int>&, const SpriteView&, int);
+template void Surface::draw_sprite<Blend::Xor>(const Coordinate<int>&, const SpriteView&, int);
+template void Surface::draw_sprite<Blend::Additive>(const Coordinate<int>&, const SpriteView&, int);
+
+template void Surface::draw_filled_rectangle<Blend::Opaque>(const Coordinate<int>&, const Coordinate<int>&, const Pixel&);
+template void Surface::draw_filled_rectangle<Blend::Transparent>(const Coordinate<int>&, const Coordinate<int>&, const Pixel&);
+template void Surface::draw_filled_rectangle<Blend::ColourOnly>(const Coordinate<int>&, const Coordinate<int>&, const Pixel&);
+template void Surface::draw_filled_rectangle<Blend::GlyphOnly>(const Coordinate<int>&, const Coordinate<int>&, const Pixel&);
+template void Surface::draw_filled_rectangle<Blend::Xor>(const Coordinate<int>&, const Coordinate<int>&, const Pixel&);
+template void Surface::draw_filled_rectangle<Blend::Additive>(const Coordinate<int>&, const Coordinate<int>&, const Pixel&);
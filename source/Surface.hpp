@@ -0,0 +1,80 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Pixel.hpp"
+#include "Blend.hpp"
+
+
+class Sprite;
+class SpriteView;
+class Text;
+
+
+class Surface {
+public:
+
+    Surface();
+    explicit Surface(const Coordinate<int>& dimensions, const Pixel & = Pixel());
+
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+    [[nodiscard]] int width() const;
+    [[nodiscard]] int height() const;
+
+    [[nodiscard]] CHAR_INFO* data();
+    [[nodiscard]] const CHAR_INFO* data() const;
+    [[nodiscard]] CHAR_INFO* row(int y);
+    [[nodiscard]] const CHAR_INFO* row(int y) const;
+
+
+    void clear(const Pixel & = Pixel::Colour::Black);
+
+    void draw_character(const Coordinate<int>&, const WCHAR character, const Pixel::Colour = Pixel::Colour::White);
+
+    // Blend operations are instantiated in Surface.cpp
+    template <typename Operation = Blend::Opaque>
+    void draw_pixel(const Coordinate<int>&, const Pixel & = Pixel::Colour::White);
+
+    template <typename Operation = Blend::Transparent>
+    void draw_sprite(const Coordinate<int>&, const Sprite&, const int scale = 1);
+    template <typename Operation = Blend::Transparent>
+    void draw_sprite(const Coordinate<int>&, const SpriteView&, const int scale = 1);
+
+    // Each line, split at '\n', is clipped once and written as a run; narrow strings are UTF-8
+    void draw_string(const Coordinate<int>&, std::wstring_view, Pixel::Colour = Pixel::Colour::White);
+    void draw_string(const Coordinate<int>&, std::string_view, Pixel::Colour = Pixel::Colour::White);
+    void draw_string(const Coordinate<int>&, const Text&, Pixel::Colour = Pixel::Colour::White);
+
+    void draw_line(const Coordinate<int>& start, const Coordinate<int>& stop, const Pixel & = Pixel::Colour::White);
+
+    void draw_triangle(const std::array<Coordinate<int>, 3>&, const Pixel & = Pixel::Colour::White);
+    void draw_filled_triangle(const std::array<Coordinate<int>, 3>&, const Pixel & = Pixel::Colour::White);
+
+    void draw_circle(const Coordinate<int>& centre, const int radius = 1, const Pixel & = Pixel::Colour::White);
+    void draw_filled_circle(const Coordinate<int>& centre, const int radius = 1, const Pixel & = Pixel::Colour::White);
+
+    void draw_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel & = Pixel::Colour::White);
+    template <typename Operation = Blend::Opaque>
+    void draw_filled_rectangle(const Coordinate<int>& top_left, const Coordinate<int>& bottom_right, const Pixel & = Pixel::Colour::White);
+
+    // Copies every cell of the source, including empty ones, one clipped row at a time
+    void blit(const Coordinate<int>&, const SpriteView&);
+
+    // Moves a rectangle of this surface to another position in it, row by row, correctly when the two overlap
+    void copy(const Coordinate<int>& source, const Coordinate<int>& dimensions, const Coordinate<int>& destination);
+    // Moves the contents of a rectangle by delta within it and fills the cells exposed
+    void scroll(const Coordinate<int>& position, const Coordinate<int>& dimensions, const Coordinate<int>& delta, const Pixel & = Pixel::Colour::Black);
+
+protected:
+
+    Coordinate<int> dimensions_;
+    std::vector<CHAR_INFO> cells_;
+
+    void resize(const Coordinate<int>& dimensions, const Pixel & = Pixel());
+
+    // Clips a rectangle placed at coordinate to this surface, giving the visible range in the rectangle's own space
+    bool clip(const Coordinate<int>& coordinate, const Coordinate<int>& dimensions, Coordinate<int>& begin, Coordinate<int>& end) const;
+
+    void draw_line_of_text(const Coordinate<int>&, std::wstring_view, WORD attributes);
+};
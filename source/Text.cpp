@@ -0,0 +1,81 @@
+#include "pch.hpp"
+
+#include "Text.hpp"
+
+
+Text::Text() = default;
+
+Text::Text(const std::string_view utf8) {
+    set(utf8);
+}
+
+void Text::set(const std::string_view utf8) {
+    if (utf8 == string_) {
+        return;
+    }
+    string_.assign(utf8);
+    glyphs_.clear();
+    decode(utf8, glyphs_);
+
+    dimensions_ = { 0, glyphs_.empty() ? 0 : 1 };
+    int line = 0;
+    for (const WCHAR glyph : glyphs_) {
+        if (glyph == L'\n') {
+            ++dimensions_.y;
+            line = 0;
+        } else {
+            dimensions_.x = ++line > dimensions_.x ? line : dimensions_.x;
+        }
+    }
+}
+
+const std::string& Text::string() const {
+    return string_;
+}
+
+std::wstring_view Text::glyphs() const {
+    return glyphs_;
+}
+
+const Coordinate<int>& Text::dimensions() const {
+    return dimensions_;
+}
+
+void Text::decode(const std::string_view utf8, std::wstring& glyphs) {
+    constexpr WCHAR replacement = 0xFFFD;
+    glyphs.reserve(glyphs.size() + utf8.size());
+
+    for (size_t index = 0; index < utf8.size();) {
+        const auto lead = static_cast<uint8_t>(utf8[index]);
+        if (lead < 0x80) {
+            glyphs.push_back(static_cast<WCHAR>(lead));
+            ++index;
+            continue;
+        }
+
+        // C0, C1 and F5 to FF never start a valid sequence
+        const size_t length = lead >= 0xF5 ? 0 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 ? 2 : 0;
+        if (length == 0) {
+            glyphs.push_back(replacement);
+            ++index;
+            continue;
+        }
+        uint32_t code = lead & (0x7Fu >> length);
+        size_t read = 1;
+        for (; read < length and index + read < utf8.size(); ++read) {
+            const auto continuation = static_cast<uint8_t>(utf8[index + read]);
+            if ((continuation & 0xC0) != 0x80) {
+                break;
+            }
+            code = code << 6 | (continuation & 0x3F);
+        }
+        index += read;
+
+        constexpr std::array<uint32_t, 5> minimum = { 0, 0, 0x80, 0x800, 0x10000 };
+        if (read < length or code < minimum[length] or (code >= 0xD800 and code <= 0xDFFF) or code > 0xFFFF) {
+            glyphs.push_back(replacement);
+        } else {
+            glyphs.push_back(static_cast<WCHAR>(code));
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+
+
+// A string kept decoded into the UTF-16 code units console cells hold, for labels drawn every frame: decoding only
+// happens when the string changes.
+class Text {
+public:
+
+    Text();
+    explicit Text(std::string_view utf8);
+
+    // Does nothing when the string is unchanged
+    void set(std::string_view utf8);
+
+    [[nodiscard]] const std::string& string() const;
+    [[nodiscard]] std::wstring_view glyphs() const;
+    // Width of the longest line by the number of lines, in cells
+    [[nodiscard]] const Coordinate<int>& dimensions() const;
+
+    // Appends the decoded string to glyphs. Malformed sequences, and characters outside the basic multilingual plane
+    // that a single cell cannot hold, become U+FFFD.
+    static void decode(std::string_view utf8, std::wstring& glyphs);
+
+private:
+
+    std::string string_;
+    std::wstring glyphs_;
+    Coordinate<int> dimensions_;
+};
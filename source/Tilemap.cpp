@@ -0,0 +1,215 @@
+#include "pch.hpp"
+
+#include "Tilemap.hpp"
+
+
+namespace {
+    // Runs in the initializer list, before the chunk counts are divided out
+    int validated_chunk_tiles(const Coordinate<int>& tile_dimensions, const Coordinate<int>& map_dimensions, const int chunk_tiles) {
+        if (not (tile_dimensions > Coordinate<int>(0, 0)) or not (map_dimensions > Coordinate<int>(0, 0)) or chunk_tiles <= 0) {
+            throw std::invalid_argument("Tilemap dimensions must be positive");
+        }
+        return chunk_tiles;
+    }
+}
+
+
+Tilemap::Tilemap(const SpriteAtlas& tiles, const Coordinate<int>& tile_dimensions, const Coordinate<int>& map_dimensions, const Pixel& background, const int chunk_tiles)
+    : tiles_(tiles.views(0, tiles.size())), tile_dimensions_(tile_dimensions), map_dimensions_(map_dimensions), background_(background),
+    chunk_tiles_(validated_chunk_tiles(tile_dimensions, map_dimensions, chunk_tiles)), chunk_dimensions_(tile_dimensions * chunk_tiles_),
+    chunks_((map_dimensions + Coordinate<int>(chunk_tiles_ - 1, chunk_tiles_ - 1)) / chunk_tiles_), chunk_cache_(static_cast<size_t>(chunks_.x) * chunks_.y) {}
+
+
+const Coordinate<int>& Tilemap::map_dimensions() const {
+    return map_dimensions_;
+}
+
+const Coordinate<int>& Tilemap::tile_dimensions() const {
+    return tile_dimensions_;
+}
+
+size_t Tilemap::layers() const {
+    return layers_.size();
+}
+
+size_t Tilemap::add_layer(const Layer type) {
+    layers_.push_back({ type, std::vector<int>(static_cast<size_t>(map_dimensions_.x) * map_dimensions_.y, Empty) });
+    return layers_.size() - 1;
+}
+
+
+int Tilemap::tile(const size_t layer, const Coordinate<int>& tile) const {
+    if (layer >= layers_.size() or not tile.in_bounds(map_dimensions_)) {
+        return Empty;
+    }
+    return layers_[layer].tiles[tile.to_index(map_dimensions_.x)];
+}
+
+void Tilemap::set_tile(const size_t layer, const Coordinate<int>& tile, const int index) {
+    if (layer >= layers_.size() or not tile.in_bounds(map_dimensions_)) {
+        throw std::out_of_range("Tile is outside the tilemap");
+    }
+    if (index != Empty and (index < 0 or static_cast<size_t>(index) >= tiles_.size())) {
+        throw std::invalid_argument("Tile index is not in the atlas");
+    }
+    int& current = layers_[layer].tiles[tile.to_index(map_dimensions_.x)];
+    if (current == index) {
+        return;
+    }
+    current = index;
+    if (layers_[layer].type == Layer::Static) {
+        chunk_cache_[(tile / chunk_tiles_).to_index(chunks_.x)].dirty = true;
+        const Coordinate<int> position = tile * tile_dimensions_ - view_camera_;
+        if (position < view_.dimensions() and position + tile_dimensions_ > Coordinate<int>(0, 0)) {
+            view_valid_ = false;
+        }
+    }
+}
+
+
+void Tilemap::render(Surface& target, const Coordinate<int>& camera) {
+    ++frame_;
+
+    const Coordinate<int>& dimensions = target.dimensions();
+    if (view_.dimensions() != dimensions) {
+        view_ = Sprite(dimensions);
+        view_valid_ = false;
+    }
+
+    const Coordinate<int> delta = camera - view_camera_;
+    const Coordinate<int> distance = { delta.x < 0 ? -delta.x : delta.x, delta.y < 0 ? -delta.y : delta.y };
+    if (not view_valid_ or not (distance < dimensions)) {
+        view_camera_ = camera;
+        compose({ 0, 0 }, dimensions);
+        view_valid_ = true;
+    } else if (delta != Coordinate<int>(0, 0)) {
+        view_.scroll({ 0, 0 }, dimensions, -delta, background_);
+        view_camera_ = camera;
+        if (delta.x > 0) {
+            compose({ dimensions.x - delta.x, 0 }, { delta.x, dimensions.y });
+        } else if (delta.x < 0) {
+            compose({ 0, 0 }, { -delta.x, dimensions.y });
+        }
+        if (delta.y > 0) {
+            compose({ 0, dimensions.y - delta.y }, { dimensions.x, delta.y });
+        } else if (delta.y < 0) {
+            compose({ 0, 0 }, { dimensions.x, -delta.y });
+        }
+    }
+
+    target.blit({ 0, 0 }, view_);
+
+    const Coordinate<int> map_cells = map_dimensions_ * tile_dimensions_;
+    const Coordinate<int> begin = { camera.x > 0 ? camera.x : 0, camera.y > 0 ? camera.y : 0 };
+    const Coordinate<int> end = {
+        camera.x + dimensions.x < map_cells.x ? camera.x + dimensions.x : map_cells.x,
+        camera.y + dimensions.y < map_cells.y ? camera.y + dimensions.y : map_cells.y,
+    };
+    if (begin < end) {
+        const Coordinate<int> first = begin / tile_dimensions_;
+        const Coordinate<int> last = (end - Coordinate<int>(1, 1)) / tile_dimensions_;
+        for (const LayerData& layer : layers_) {
+            if (layer.type != Layer::Dynamic) {
+                continue;
+            }
+            Coordinate<int> tile;
+            for (tile.y = first.y; tile.y <= last.y; ++tile.y) {
+                const int* tiles = layer.tiles.data() + static_cast<size_t>(tile.y) * map_dimensions_.x;
+                for (tile.x = first.x; tile.x <= last.x; ++tile.x) {
+                    if (const int index = tiles[tile.x]; index != Empty) {
+                        target.draw_sprite(tile * tile_dimensions_ - camera, tiles_[index]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Keep a margin of chunks around the view so scrolling back and forth does not re-rasterise
+    const Coordinate<int> visible = dimensions / chunk_dimensions_ + Coordinate<int>(2, 2);
+    evict(static_cast<size_t>(visible.x) * visible.y * 4);
+}
+
+
+const Sprite& Tilemap::chunk(const Coordinate<int>& chunk) {
+    Chunk& cached = chunk_cache_[chunk.to_index(chunks_.x)];
+    cached.last_used = frame_;
+    if (not cached.sprite) {
+        cached.sprite = std::make_unique<Sprite>(chunk_dimensions_);
+        cached.dirty = true;
+        ++cached_chunks_;
+    }
+    if (cached.dirty) {
+        Sprite& sprite = *cached.sprite;
+        sprite.clear(background_);
+        const Coordinate<int> first = chunk * chunk_tiles_;
+        const Coordinate<int> last = {
+            first.x + chunk_tiles_ < map_dimensions_.x ? first.x + chunk_tiles_ : map_dimensions_.x,
+            first.y + chunk_tiles_ < map_dimensions_.y ? first.y + chunk_tiles_ : map_dimensions_.y,
+        };
+        for (const LayerData& layer : layers_) {
+            if (layer.type != Layer::Static) {
+                continue;
+            }
+            Coordinate<int> tile;
+            for (tile.y = first.y; tile.y < last.y; ++tile.y) {
+                for (tile.x = first.x; tile.x < last.x; ++tile.x) {
+                    if (const int index = layer.tiles[tile.to_index(map_dimensions_.x)]; index != Empty) {
+                        sprite.draw_sprite((tile - first) * tile_dimensions_, tiles_[index]);
+                    }
+                }
+            }
+        }
+        cached.dirty = false;
+    }
+    return *cached.sprite;
+}
+
+void Tilemap::compose(const Coordinate<int>& position, const Coordinate<int>& dimensions) {
+    view_.draw_filled_rectangle(position, position + dimensions - Coordinate<int>(1, 1), background_);
+
+    const Coordinate<int> map_cells = map_dimensions_ * tile_dimensions_;
+    const Coordinate<int> world = view_camera_ + position;
+    const Coordinate<int> begin = { world.x > 0 ? world.x : 0, world.y > 0 ? world.y : 0 };
+    const Coordinate<int> end = {
+        world.x + dimensions.x < map_cells.x ? world.x + dimensions.x : map_cells.x,
+        world.y + dimensions.y < map_cells.y ? world.y + dimensions.y : map_cells.y,
+    };
+    if (not (begin < end)) {
+        return;
+    }
+
+    const Coordinate<int> first = begin / chunk_dimensions_;
+    const Coordinate<int> last = (end - Coordinate<int>(1, 1)) / chunk_dimensions_;
+    Coordinate<int> current;
+    for (current.y = first.y; current.y <= last.y; ++current.y) {
+        for (current.x = first.x; current.x <= last.x; ++current.x) {
+            const Coordinate<int> origin = current * chunk_dimensions_;
+            const Coordinate<int> from = { begin.x > origin.x ? begin.x : origin.x, begin.y > origin.y ? begin.y : origin.y };
+            const Coordinate<int> to = {
+                end.x < origin.x + chunk_dimensions_.x ? end.x : origin.x + chunk_dimensions_.x,
+                end.y < origin.y + chunk_dimensions_.y ? end.y : origin.y + chunk_dimensions_.y,
+            };
+            view_.blit(from - view_camera_, SpriteView(chunk(current), from - origin, to - from));
+        }
+    }
+}
+
+// Evicts the chunks seen longest ago first, so those just scrolled off screen stay cached
+void Tilemap::evict(const size_t limit) {
+    if (cached_chunks_ <= limit) {
+        return;
+    }
+    evictable_.clear();
+    for (size_t index = 0; index < chunk_cache_.size(); ++index) {
+        if (chunk_cache_[index].sprite and chunk_cache_[index].last_used != frame_) {
+            evictable_.push_back(index);
+        }
+    }
+    const size_t count = cached_chunks_ - limit < evictable_.size() ? cached_chunks_ - limit : evictable_.size();
+    const auto older = [this](const size_t lhs, const size_t rhs) { return chunk_cache_[lhs].last_used < chunk_cache_[rhs].last_used; };
+    std::nth_element(evictable_.begin(), evictable_.begin() + static_cast<std::ptrdiff_t>(count), evictable_.end(), older);
+    for (size_t index = 0; index < count; ++index) {
+        chunk_cache_[evictable_[index]].sprite.reset();
+    }
+    cached_chunks_ -= count;
+}
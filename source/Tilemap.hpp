@@ -0,0 +1,75 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Pixel.hpp"
+#include "Sprite.hpp"
+#include "SpriteAtlas.hpp"
+#include "Surface.hpp"
+
+
+// Layers of tiles drawn from an atlas. Static layers are composited, in order, into chunk sprites that are rendered on
+// first sight and into a viewport cache that is shifted when the camera moves, so only newly exposed rows and columns
+// are rasterised. Once more chunks are cached than cover the view and a margin around it, those seen longest ago are
+// evicted. Dynamic layers are drawn over them tile by tile every frame, culled to the viewport.
+class Tilemap {
+public:
+
+    static constexpr int Empty = -1;
+
+    enum class Layer : char {
+        Static,
+        Dynamic,
+    };
+
+    Tilemap(const SpriteAtlas& tiles, const Coordinate<int>& tile_dimensions, const Coordinate<int>& map_dimensions, const Pixel& background = Pixel::Colour::Black, int chunk_tiles = 16);
+
+    [[nodiscard]] const Coordinate<int>& map_dimensions() const;
+    [[nodiscard]] const Coordinate<int>& tile_dimensions() const;
+    [[nodiscard]] size_t layers() const;
+
+    size_t add_layer(Layer = Layer::Static);
+
+    [[nodiscard]] int tile(size_t layer, const Coordinate<int>& tile) const;
+    void set_tile(size_t layer, const Coordinate<int>& tile, int index);
+
+    // Draws the map with the camera, in cells, at the target's top left
+    void render(Surface& target, const Coordinate<int>& camera);
+
+private:
+
+    struct LayerData {
+        Layer type;
+        std::vector<int> tiles;
+    };
+
+    struct Chunk {
+        std::unique_ptr<Sprite> sprite;
+        bool dirty = true;
+        unsigned last_used = 0;
+    };
+
+    const std::vector<SpriteView> tiles_;
+    const Coordinate<int> tile_dimensions_;
+    const Coordinate<int> map_dimensions_;
+    const Pixel background_;
+    const int chunk_tiles_;
+    const Coordinate<int> chunk_dimensions_;
+    const Coordinate<int> chunks_;
+
+    std::vector<LayerData> layers_;
+    std::vector<Chunk> chunk_cache_;
+    size_t cached_chunks_ = 0;
+    // Scratch for evict(), kept to reuse its storage
+    std::vector<size_t> evictable_;
+    unsigned frame_ = 0;
+
+    Sprite view_;
+    Coordinate<int> view_camera_;
+    bool view_valid_ = false;
+
+    const Sprite& chunk(const Coordinate<int>& chunk);
+    void compose(const Coordinate<int>& position, const Coordinate<int>& dimensions);
+    void evict(size_t limit);
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+
+
+template <typename type>
+struct Vector3 {
+
+    type x, y, z;
+
+    constexpr Vector3() : x(static_cast<type>(0)), y(static_cast<type>(0)), z(static_cast<type>(0)) {}
+    constexpr Vector3(type x, type y, type z) : x(x), y(y), z(z) {}
+    constexpr Vector3(const Coordinate<type>& coordinate, type z) : x(coordinate.x), y(coordinate.y), z(z) {}
+
+    constexpr Vector3 operator-() const { return { -x, -y, -z }; }
+
+    constexpr Vector3& operator+=(const Vector3& other) { return *this = *this + other; }
+    constexpr Vector3& operator-=(const Vector3& other) { return *this = *this - other; }
+    constexpr Vector3& operator*=(const Vector3& other) { return *this = *this * other; }
+    constexpr Vector3& operator/=(const Vector3& other) { return *this = *this / other; }
+
+    constexpr Vector3& operator*=(const type scalar) { return *this = *this * scalar; }
+    constexpr Vector3& operator/=(const type scalar) { return *this = *this / scalar; }
+
+    constexpr Coordinate<type> xy() const { return { x, y }; }
+
+    friend constexpr Vector3 operator+(const Vector3& lhs, const Vector3& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z }; }
+    friend constexpr Vector3 operator-(const Vector3& lhs, const Vector3& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z }; }
+    friend constexpr Vector3 operator*(const Vector3& lhs, const Vector3& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z }; }
+    friend constexpr Vector3 operator/(const Vector3& lhs, const Vector3& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z }; }
+
+    friend constexpr Vector3 operator*(const Vector3& lhs, const type rhs) { return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs }; }
+    friend constexpr Vector3 operator*(const type lhs, const Vector3& rhs) { return rhs * lhs; }
+    friend constexpr Vector3 operator/(const Vector3& lhs, const type rhs) { return { lhs.x / rhs, lhs.y / rhs, lhs.z / rhs }; }
+
+    friend constexpr bool operator==(const Vector3& lhs, const Vector3& rhs) = default;
+
+    friend std::ostream& operator<<(std::ostream& stream, const Vector3& vector) { return stream << vector.x << ' ' << vector.y << ' ' << vector.z; }
+    friend std::istream& operator>>(std::istream& stream, Vector3& vector) { return stream >> vector.x >> vector.y >> vector.z; }
+
+    template <typename type2>
+    constexpr explicit operator Vector3<type2>() const {
+        return { static_cast<type2>(x), static_cast<type2>(y), static_cast<type2>(z) };
+    }
+};
+
+
+template <typename type>
+struct Vector4 {
+
+    type x, y, z, w;
+
+    constexpr Vector4() : x(static_cast<type>(0)), y(static_cast<type>(0)), z(static_cast<type>(0)), w(static_cast<type>(0)) {}
+    constexpr Vector4(type x, type y, type z, type w) : x(x), y(y), z(z), w(w) {}
+    constexpr Vector4(const Vector3<type>& vector, type w) : x(vector.x), y(vector.y), z(vector.z), w(w) {}
+
+    constexpr Vector4 operator-() const { return { -x, -y, -z, -w }; }
+
+    constexpr Vector4& operator+=(const Vector4& other) { return *this = *this + other; }
+    constexpr Vector4& operator-=(const Vector4& other) { return *this = *this - other; }
+    constexpr Vector4& operator*=(const Vector4& other) { return *this = *this * other; }
+    constexpr Vector4& operator/=(const Vector4& other) { return *this = *this / other; }
+
+    constexpr Vector4& operator*=(const type scalar) { return *this = *this * scalar; }
+    constexpr Vector4& operator/=(const type scalar) { return *this = *this / scalar; }
+
+    constexpr Vector3<type> xyz() const { return { x, y, z }; }
+
+    friend constexpr Vector4 operator+(const Vector4& lhs, const Vector4& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w }; }
+    friend constexpr Vector4 operator-(const Vector4& lhs, const Vector4& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z, lhs.w - rhs.w }; }
+    friend constexpr Vector4 operator*(const Vector4& lhs, const Vector4& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z, lhs.w * rhs.w }; }
+    friend constexpr Vector4 operator/(const Vector4& lhs, const Vector4& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z, lhs.w / rhs.w }; }
+
+    friend constexpr Vector4 operator*(const Vector4& lhs, const type rhs) { return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs }; }
+    friend constexpr Vector4 operator*(const type lhs, const Vector4& rhs) { return rhs * lhs; }
+    friend constexpr Vector4 operator/(const Vector4& lhs, const type rhs) { return { lhs.x / rhs, lhs.y / rhs, lhs.z / rhs, lhs.w / rhs }; }
+
+    friend constexpr bool operator==(const Vector4& lhs, const Vector4& rhs) = default;
+
+    friend std::ostream& operator<<(std::ostream& stream, const Vector4& vector) { return stream << vector.x << ' ' << vector.y << ' ' << vector.z << ' ' << vector.w; }
+    friend std::istream& operator>>(std::istream& stream, Vector4& vector) { return stream >> vector.x >> vector.y >> vector.z >> vector.w; }
+
+    template <typename type2>
+    constexpr explicit operator Vector4<type2>() const {
+        return { static_cast<type2>(x), static_cast<type2>(y), static_cast<type2>(z), static_cast<type2>(w) };
+    }
+};
+
+
+template <typename type>
+constexpr type dot(const Vector3<type>& lhs, const Vector3<type>& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z; }
+
+template <typename type>
+constexpr type dot(const Vector4<type>& lhs, const Vector4<type>& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w; }
+
+template <typename type>
+constexpr Vector3<type> cross(const Vector3<type>& lhs, const Vector3<type>& rhs) {
+    return { lhs.y * rhs.z - lhs.z * rhs.y, lhs.z * rhs.x - lhs.x * rhs.z, lhs.x * rhs.y - lhs.y * rhs.x };
+}
+
+template <typename type>
+type length(const Vector3<type>& vector) { return static_cast<type>(std::sqrt(dot(vector, vector))); }
+
+template <typename type>
+type length(const Vector4<type>& vector) { return static_cast<type>(std::sqrt(dot(vector, vector))); }
+
+template <typename vector_type>
+vector_type normalise(const vector_type& vector) { return vector / length(vector); }
@@ -0,0 +1,173 @@
+#include "pch.hpp"
+
+#include "World.hpp"
+
+
+World::World(JobSystem& jobs) : jobs_(jobs) {
+    auto empty = std::make_unique<Archetype>();
+    empty->mask = 0;
+    masks_[0] = empty.get();
+    archetypes_.push_back(std::move(empty));
+}
+
+
+// Entities
+
+
+World::Entity World::create() {
+    structural_change();
+    uint32_t index;
+    if (free_.empty()) {
+        index = static_cast<uint32_t>(records_.size());
+        records_.push_back({ nullptr, 0, 0 });
+    } else {
+        index = free_.back();
+        free_.pop_back();
+    }
+    Record& record = records_[index];
+    Archetype& empty = *archetypes_.front();
+    const Entity entity = { index, record.generation };
+    record.archetype = &empty;
+    record.row = empty.entities.size();
+    empty.entities.push_back(entity);
+    ++size_;
+    return entity;
+}
+
+void World::destroy(const Entity entity) {
+    structural_change();
+    const Record& record = location(entity);
+    erase(*record.archetype, record.row);
+    records_[entity.index] = { nullptr, 0, record.generation + 1 };
+    free_.push_back(entity.index);
+    --size_;
+}
+
+bool World::alive(const Entity entity) const {
+    return entity.index < records_.size() and records_[entity.index].archetype and records_[entity.index].generation == entity.generation;
+}
+
+size_t World::size() const {
+    return size_;
+}
+
+
+// Systems
+
+
+void World::update(const double frame_time) {
+    running_ = true;
+    for (const std::vector<size_t>& phase : phases_) {
+        if (phase.size() == 1) {
+            systems_[phase.front()].run(*this, frame_time);
+            continue;
+        }
+        jobs_.parallel_for(0, static_cast<int>(phase.size()), [&](const int first, const int last) {
+            for (int index = first; index < last; ++index) {
+                systems_[phase[index]].run(*this, frame_time);
+            }
+        });
+    }
+    running_ = false;
+}
+
+void World::draw(Surface& surface) {
+    batch_.clear();
+    each<const Position, const Drawable>([&](const Position& position, const Drawable& drawable) {
+        batch_.push_back({ drawable.depth, { static_cast<int>(std::floor(position.value.x)), static_cast<int>(std::floor(position.value.y)) }, &drawable });
+    });
+    std::stable_sort(batch_.begin(), batch_.end(), [](const Batched& lhs, const Batched& rhs) { return lhs.depth < rhs.depth; });
+    for (const Batched& batched : batch_) {
+        surface.draw_sprite(batched.position, batched.drawable->view, batched.drawable->scale);
+    }
+}
+
+
+// Private
+
+
+size_t World::next_component() {
+    static std::atomic<size_t> next = 0;
+    const size_t index = next++;
+    if (index >= 64) {
+        throw std::out_of_range("World supports at most 64 component types");
+    }
+    return index;
+}
+
+const World::Record& World::location(const Entity entity) const {
+    if (not alive(entity)) {
+        throw std::invalid_argument("Entity is not alive");
+    }
+    return records_[entity.index];
+}
+
+void World::structural_change() const {
+    if (running_) {
+        throw std::runtime_error("Entities cannot change while systems are running");
+    }
+}
+
+World::Archetype& World::archetype(const uint64_t mask, const Archetype& source, const std::function<std::unique_ptr<ColumnBase>()>& added) {
+    if (const auto found = masks_.find(mask); found != masks_.end()) {
+        return *found->second;
+    }
+    auto created = std::make_unique<Archetype>();
+    created->mask = mask;
+    for (uint64_t bits = mask; bits; bits &= bits - 1) {
+        const int index = std::countr_zero(bits);
+        created->columns[index] = source.columns[index] ? source.columns[index]->empty() : added();
+    }
+    Archetype& result = *created;
+    masks_[mask] = &result;
+    archetypes_.push_back(std::move(created));
+    return result;
+}
+
+const World::Record& World::move(const Entity entity, const uint64_t mask, const std::function<std::unique_ptr<ColumnBase>()>& added) {
+    structural_change();
+    location(entity);
+    Record& record = records_[entity.index];
+    Archetype& source = *record.archetype;
+    if (source.mask == mask) {
+        return record;
+    }
+    Archetype& destination = archetype(mask, source, added);
+    for (uint64_t bits = mask; bits; bits &= bits - 1) {
+        const int index = std::countr_zero(bits);
+        if (source.columns[index]) {
+            destination.columns[index]->push(*source.columns[index], record.row);
+        } else {
+            destination.columns[index]->push();
+        }
+    }
+    destination.entities.push_back(entity);
+    erase(source, record.row);
+    record.archetype = &destination;
+    record.row = destination.entities.size() - 1;
+    return record;
+}
+
+void World::erase(Archetype& archetype, const size_t row) {
+    for (uint64_t bits = archetype.mask; bits; bits &= bits - 1) {
+        archetype.columns[std::countr_zero(bits)]->erase(row);
+    }
+    if (row + 1 != archetype.entities.size()) {
+        archetype.entities[row] = archetype.entities.back();
+        records_[archetype.entities[row].index].row = row;
+    }
+    archetype.entities.pop_back();
+}
+
+void World::schedule(System&& system) {
+    // Reads include writes, so this also catches two systems writing the same component
+    const auto conflicts = [&](const size_t index) {
+        const System& other = systems_[index];
+        return (system.writes & other.reads) or (other.writes & system.reads);
+    };
+    if (phases_.empty() or std::any_of(phases_.back().begin(), phases_.back().end(), conflicts)) {
+        phases_.emplace_back();
+    }
+    phases_.back().push_back(systems_.size());
+    systems_.push_back(std::move(system));
+}
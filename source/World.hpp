@@ -0,0 +1,192 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "Coordinate.hpp"
+#include "Surface.hpp"
+#include "SpriteView.hpp"
+#include "JobSystem.hpp"
+
+
+// Built-in components used by World::draw
+struct Position {
+    Coordinate<double> value;
+};
+
+struct Drawable {
+    SpriteView view;
+    int depth = 0;
+    int scale = 1;
+};
+
+
+// Entity component system storing components in archetype tables: every entity with the same set of components lives in
+// the same table, one contiguous array per component. Systems run once per update; consecutive systems whose read and
+// write sets do not conflict run in parallel on the job system. Components are any movable, default constructible
+// types, up to 64 of them. Entities must not be created, destroyed or change components while systems are running.
+class World {
+public:
+
+    struct Entity {
+        uint32_t index;
+        uint32_t generation;
+        friend bool operator==(const Entity&, const Entity&) = default;
+    };
+
+    explicit World(JobSystem&);
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+    World(World&&) = delete;
+    World& operator=(World&&) = delete;
+
+    // Entities
+    Entity create();
+    void destroy(Entity);
+    [[nodiscard]] bool alive(Entity) const;
+    [[nodiscard]] size_t size() const;
+
+    // Components
+    template <typename Component>
+    Component& add(const Entity entity, Component component = Component()) {
+        const Record& record = move(entity, location(entity).archetype->mask | bit<Component>(), [] { return std::make_unique<Column<Component>>(); });
+        Component& added = column<Component>(*record.archetype)[record.row];
+        added = std::move(component);
+        return added;
+    }
+
+    template <typename Component>
+    void remove(const Entity entity) {
+        move(entity, location(entity).archetype->mask & ~bit<Component>(), nullptr);
+    }
+
+    template <typename Component>
+    [[nodiscard]] bool has(const Entity entity) const {
+        return (location(entity).archetype->mask & bit<Component>()) != 0;
+    }
+
+    template <typename Component>
+    [[nodiscard]] Component& get(const Entity entity) {
+        const Record& record = location(entity);
+        if (not (record.archetype->mask & bit<Component>())) {
+            throw std::invalid_argument("Entity does not have the component");
+        }
+        return column<Component>(*record.archetype)[record.row];
+    }
+
+    // Calls function(Components&...) for every entity having all the components; const components are only read
+    template <typename... Components, typename Function>
+    void each(Function&& function) {
+        const uint64_t required = (bit<std::remove_const_t<Components>>() | ...);
+        for (const auto& archetype : archetypes_) {
+            if ((archetype->mask & required) != required or archetype->entities.empty()) {
+                continue;
+            }
+            [&, rows = archetype->entities.size()](Components*... components) {
+                for (size_t row = 0; row < rows; ++row) {
+                    function(components[row]...);
+                }
+            }(column<std::remove_const_t<Components>>(*archetype)...);
+        }
+    }
+
+    // Systems: function(double frame_time, Components&...), run in the order added unless they can overlap
+    template <typename... Components, typename Function>
+    void add_system(Function function) {
+        schedule({
+            (bit<std::remove_const_t<Components>>() | ...),
+            ((std::is_const_v<Components> ? 0 : bit<std::remove_const_t<Components>>()) | ...),
+            [function](World& world, const double frame_time) {
+                world.each<Components...>([&](Components&... components) { function(frame_time, components...); });
+            },
+        });
+    }
+
+    void update(double frame_time);
+
+    // Render system: draws every entity with a position and a drawable in one batch, in order of depth
+    void draw(Surface&);
+
+private:
+
+    struct ColumnBase {
+        virtual ~ColumnBase() = default;
+        [[nodiscard]] virtual std::unique_ptr<ColumnBase> empty() const = 0;
+        virtual void push() = 0;
+        // Appends the source's element at row, leaving the source row moved from
+        virtual void push(ColumnBase& source, size_t row) = 0;
+        // Removes the element at row by moving the last element into it
+        virtual void erase(size_t row) = 0;
+    };
+
+    template <typename Component>
+    struct Column final : ColumnBase {
+        std::vector<Component> elements;
+
+        std::unique_ptr<ColumnBase> empty() const override { return std::make_unique<Column>(); }
+        void push() override { elements.emplace_back(); }
+        void push(ColumnBase& source, const size_t row) override { elements.push_back(std::move(static_cast<Column&>(source).elements[row])); }
+        void erase(const size_t row) override {
+            if (row + 1 != elements.size()) {
+                elements[row] = std::move(elements.back());
+            }
+            elements.pop_back();
+        }
+    };
+
+    struct Archetype {
+        uint64_t mask;
+        std::vector<Entity> entities;
+        std::array<std::unique_ptr<ColumnBase>, 64> columns;
+    };
+
+    struct Record {
+        Archetype* archetype;
+        size_t row;
+        uint32_t generation;
+    };
+
+    struct System {
+        uint64_t reads, writes;
+        std::function<void(World&, double)> run;
+    };
+
+    JobSystem& jobs_;
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::unordered_map<uint64_t, Archetype*> masks_;
+    std::vector<Record> records_;
+    std::vector<uint32_t> free_;
+    size_t size_ = 0;
+
+    std::vector<System> systems_;
+    // Consecutive runs of systems that can run at the same time
+    std::vector<std::vector<size_t>> phases_;
+    bool running_ = false;
+
+    struct Batched {
+        int depth;
+        Coordinate<int> position;
+        const Drawable* drawable;
+    };
+    std::vector<Batched> batch_;
+
+    static size_t next_component();
+
+    template <typename Component>
+    static uint64_t bit() {
+        static const size_t index = next_component();
+        return uint64_t(1) << index;
+    }
+
+    template <typename Component>
+    static Component* column(Archetype& archetype) {
+        return static_cast<Column<Component>&>(*archetype.columns[std::countr_zero(bit<Component>())]).elements.data();
+    }
+
+    const Record& location(Entity) const;
+    void structural_change() const;
+    Archetype& archetype(uint64_t mask, const Archetype& source, const std::function<std::unique_ptr<ColumnBase>()>& added);
+    const Record& move(Entity, uint64_t mask, const std::function<std::unique_ptr<ColumnBase>()>& added);
+    void erase(Archetype&, size_t row);
+    void schedule(System&&);
+};
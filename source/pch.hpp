@@ -7,24 +7,37 @@
 #include <vector>
 #include <array>
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <initializer_list>
 #include <unordered_map>
+#include <map>
+#include <list>
+#include <deque>
+#include <bitset>
 
 // Input and output
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <sstream>
 
 // Maths
 #include <cmath>
+#include <limits>
 #include <algorithm>
 #include <numeric>
+#include <bit>
 #include <random>
 #include <functional>
 
 // Utility
 #include <utility>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <span>
+#include <charconv>
 
 // Exceptions
 #include <exception>
@@ -33,4 +46,7 @@
 // Timing and multi-threading
 #include <chrono>
 #include <thread>
-#include <mutex>
\ No newline at end of file
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <future>
\ No newline at end of file